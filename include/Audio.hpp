@@ -2,6 +2,7 @@
 #ifndef AUDIO_HPP
 #define AUDIO_HPP
 
+#include <chrono>
 #include <string>
 struct AudioData;
 
@@ -23,6 +24,8 @@ public:
 
 	bool running() const;
 	bool modified() const;
+	// blocks until new audio is available or the timeout expires, returns modified()
+	bool waitForData(std::chrono::milliseconds timeout);
 	int ups() const;
 
 	void copyData(AudioData& audioData);
@@ -0,0 +1,39 @@
+#pragma once
+#ifndef AUDIO_FILE_HPP
+#define AUDIO_FILE_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+/**
+ * Reads uncompressed WAV files, the samples are converted to interleaved floats in [-1, 1].
+ * Supported sample formats are 8, 16, 24 and 32 bit integers as well as 32 and 64 bit floats.
+ */
+class AudioFile {
+public:
+	AudioFile() = default;
+	AudioFile(const std::filesystem::path& filePath);
+
+	void open(const std::filesystem::path& filePath);
+
+	const std::vector<float>& samples() const { return data; }
+	unsigned char channels() const { return channelCount; }
+	uint32_t sampleRate() const { return rate; }
+	// number of samples per channel
+	size_t length() const { return channelCount ? data.size() / channelCount : 0; }
+
+	/**
+	 * Returns the samples resampled to sampleRate and mixed to the given number of channels.
+	 * Mono is the average of all channels, additional channels are dropped and a mono file is
+	 * copied to every channel
+	 */
+	std::vector<float> convert(uint32_t sampleRate, unsigned char channels) const;
+
+private:
+	std::vector<float> data;
+	unsigned char channelCount = 0;
+	uint32_t rate = 0;
+};
+
+#endif
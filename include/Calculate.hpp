@@ -1,4 +1,11 @@
+#include <string>
 #include <string_view>
+#include <unordered_map>
 
 template <class NumType>
 NumType calculate(std::string_view expression);
+
+// variables are looked up like the constants, which they take precedence over
+template <class NumType>
+NumType calculate(std::string_view expression,
+                  const std::unordered_map<std::string, float>& variables);
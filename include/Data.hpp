@@ -12,6 +12,9 @@ struct AudioData {
 	float lVolume = 0.f;
 	float rVolume = 0.f;
 
+	// number of samples per channel added to the end of buffer by the last copy
+	size_t newSamples = 0;
+
 	AudioData();
 
 	void allocate(size_t channels, size_t channelSize);
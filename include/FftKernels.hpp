@@ -0,0 +1,186 @@
+#pragma once
+#ifndef FFT_KERNELS_HPP
+#define FFT_KERNELS_HPP
+
+#include <cstddef>
+
+/**
+ * Butterfly kernels operating on bit reversed data in a split real/imaginary layout.
+ * Each instruction set lives in its own translation unit so that it can be compiled with the
+ * matching target flags, the best supported one is picked at runtime by FftPlan.
+ * Nothing but intrinsics and the helpers below may be used by the instruction set specific
+ * translation units, as any shared inline function emitted there could be picked by the linker
+ * for the whole program. That's why every helper below is a template over the vector type, which
+ * each translation unit declares with internal linkage, so no two of them share an instantiation.
+ */
+namespace fft {
+	typedef void (*Kernel)(float* re, float* im, size_t size, const float* twRe,
+	                       const float* twIm);
+
+	void scalarButterflies(float* re, float* im, size_t size, const float* twRe,
+	                       const float* twIm);
+#ifdef FFT_X86_KERNELS
+	void sse2Butterflies(float* re, float* im, size_t size, const float* twRe, const float* twIm);
+	void avx2Butterflies(float* re, float* im, size_t size, const float* twRe, const float* twIm);
+	void avx512Butterflies(float* re, float* im, size_t size, const float* twRe,
+	                       const float* twIm);
+#endif
+#ifdef FFT_NEON_KERNELS
+	void neonButterflies(float* re, float* im, size_t size, const float* twRe, const float* twIm);
+#endif
+
+	namespace detail {
+		/**
+		 * Vector types must provide:
+		 * 	Vec, width, load, store, add, sub and mul
+		 * The scalar lanes stand in for V in stages shorter than its width, they only take V to
+		 * keep them apart from the ones of other instruction sets.
+		 */
+		template <class V>
+		struct ScalarVec {
+			typedef float Vec;
+			static constexpr size_t width = 1;
+			static Vec load(const float* p) { return *p; }
+			static void store(float* p, Vec v) { *p = v; }
+			static Vec add(Vec a, Vec b) { return a + b; }
+			static Vec sub(Vec a, Vec b) { return a - b; }
+			static Vec mul(Vec a, Vec b) { return a * b; }
+		};
+
+		/**
+		 * Stages of length 2 and 4 merged into a single pass, all of their twiddles are 1 or -i
+		 */
+		template <class V>
+		inline void firstRadix4Stage(float* re, float* im, size_t size) {
+			for (size_t k = 0; k < size; k += 4) {
+				const float a0r = re[k] + re[k + 1], a0i = im[k] + im[k + 1];
+				const float a1r = re[k] - re[k + 1], a1i = im[k] - im[k + 1];
+				const float a2r = re[k + 2] + re[k + 3], a2i = im[k + 2] + im[k + 3];
+				const float a3r = re[k + 2] - re[k + 3], a3i = im[k + 2] - im[k + 3];
+
+				re[k] = a0r + a2r;
+				im[k] = a0i + a2i;
+				re[k + 2] = a0r - a2r;
+				im[k + 2] = a0i - a2i;
+				// a3 * -i
+				re[k + 1] = a1r + a3i;
+				im[k + 1] = a1i - a3r;
+				re[k + 3] = a1r - a3i;
+				im[k + 3] = a1i + a3r;
+			}
+		}
+
+		template <class V>
+		inline void radix2Stage(float* re, float* im, size_t size, size_t m, const float* twRe,
+		                 const float* twIm) {
+			typedef typename V::Vec Vec;
+			const size_t half = m / 2;
+			for (size_t k = 0; k < size; k += m) {
+				for (size_t j = 0; j < half; j += V::width) {
+					const Vec wr = V::load(twRe + j), wi = V::load(twIm + j);
+					const Vec br = V::load(re + k + j + half), bi = V::load(im + k + j + half);
+					const Vec tr = V::sub(V::mul(wr, br), V::mul(wi, bi));
+					const Vec ti = V::add(V::mul(wr, bi), V::mul(wi, br));
+					const Vec ar = V::load(re + k + j), ai = V::load(im + k + j);
+					V::store(re + k + j, V::add(ar, tr));
+					V::store(im + k + j, V::add(ai, ti));
+					V::store(re + k + j + half, V::sub(ar, tr));
+					V::store(im + k + j + half, V::sub(ai, ti));
+				}
+			}
+		}
+
+		/**
+		 * Performs the stages of length m and 2m in a single pass over the data
+		 */
+		template <class V>
+		inline void radix4Stage(float* re, float* im, size_t size, size_t m, const float* tw1Re,
+		                 const float* tw1Im, const float* tw2Re, const float* tw2Im) {
+			typedef typename V::Vec Vec;
+			const size_t half = m / 2;
+			for (size_t k = 0; k < size; k += 2 * m) {
+				float* r0 = re + k;
+				float* i0 = im + k;
+				float* r1 = r0 + half;
+				float* i1 = i0 + half;
+				float* r2 = r0 + m;
+				float* i2 = i0 + m;
+				float* r3 = r2 + half;
+				float* i3 = i2 + half;
+				for (size_t j = 0; j < half; j += V::width) {
+					// stage m
+					const Vec w1r = V::load(tw1Re + j), w1i = V::load(tw1Im + j);
+
+					Vec ar = V::load(r0 + j), ai = V::load(i0 + j);
+					Vec br = V::load(r1 + j), bi = V::load(i1 + j);
+					Vec tr = V::sub(V::mul(w1r, br), V::mul(w1i, bi));
+					Vec ti = V::add(V::mul(w1r, bi), V::mul(w1i, br));
+					const Vec a1r = V::add(ar, tr), a1i = V::add(ai, ti);
+					const Vec b1r = V::sub(ar, tr), b1i = V::sub(ai, ti);
+
+					const Vec cr = V::load(r2 + j), ci = V::load(i2 + j);
+					const Vec dr = V::load(r3 + j), di = V::load(i3 + j);
+					tr = V::sub(V::mul(w1r, dr), V::mul(w1i, di));
+					ti = V::add(V::mul(w1r, di), V::mul(w1i, dr));
+					const Vec c1r = V::add(cr, tr), c1i = V::add(ci, ti);
+					const Vec d1r = V::sub(cr, tr), d1i = V::sub(ci, ti);
+
+					// stage 2m, the twiddle for the upper half is the lower one multiplied by -i
+					const Vec w2r = V::load(tw2Re + j), w2i = V::load(tw2Im + j);
+
+					tr = V::sub(V::mul(w2r, c1r), V::mul(w2i, c1i));
+					ti = V::add(V::mul(w2r, c1i), V::mul(w2i, c1r));
+					V::store(r0 + j, V::add(a1r, tr));
+					V::store(i0 + j, V::add(a1i, ti));
+					V::store(r2 + j, V::sub(a1r, tr));
+					V::store(i2 + j, V::sub(a1i, ti));
+
+					tr = V::sub(V::mul(w2r, d1r), V::mul(w2i, d1i));
+					ti = V::add(V::mul(w2r, d1i), V::mul(w2i, d1r));
+					// b1 + -i*t and b1 - -i*t
+					V::store(r1 + j, V::add(b1r, ti));
+					V::store(i1 + j, V::sub(b1i, tr));
+					V::store(r3 + j, V::sub(b1r, ti));
+					V::store(i3 + j, V::add(b1i, tr));
+				}
+			}
+		}
+
+		/**
+		 * Runs every stage of the fft, falling back to scalar code for stages shorter than the
+		 * vector width. The twiddles of the stage of length m start at index m/2-1.
+		 */
+		template <class V>
+		inline void butterflies(float* re, float* im, size_t size, const float* twRe,
+		                        const float* twIm) {
+			if (size < 2) return;
+			if (size == 2) {
+				radix2Stage<ScalarVec<V>>(re, im, size, 2, twRe, twIm);
+				return;
+			}
+
+			firstRadix4Stage<V>(re, im, size);
+
+			size_t m = 8;
+			for (; 2 * m <= size; m <<= 2) {
+				const float* tw1Re = twRe + m / 2 - 1;
+				const float* tw1Im = twIm + m / 2 - 1;
+				const float* tw2Re = twRe + m - 1;
+				const float* tw2Im = twIm + m - 1;
+				if (m / 2 < V::width)
+					radix4Stage<ScalarVec<V>>(re, im, size, m, tw1Re, tw1Im, tw2Re, tw2Im);
+				else
+					radix4Stage<V>(re, im, size, m, tw1Re, tw1Im, tw2Re, tw2Im);
+			}
+
+			if (m <= size) {
+				if (m / 2 < V::width)
+					radix2Stage<ScalarVec<V>>(re, im, size, m, twRe + m / 2 - 1, twIm + m / 2 - 1);
+				else
+					radix2Stage<V>(re, im, size, m, twRe + m / 2 - 1, twIm + m / 2 - 1);
+			}
+		}
+	}  // namespace detail
+}  // namespace fft
+
+#endif
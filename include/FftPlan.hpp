@@ -0,0 +1,60 @@
+#pragma once
+#ifndef FFT_PLAN_HPP
+#define FFT_PLAN_HPP
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Precomputed twiddle factors and bit reversal indices for radix 2 ffts.
+ * A plan built for size n can transform any power of 2 size up to n.
+ * The butterflies run on a split real/imaginary copy of the data using the widest vector
+ * instruction set supported by the cpu.
+ */
+class FftPlan {
+public:
+	enum class Isa { scalar, sse2, avx2, avx512, neon };
+
+	static Isa detectIsa();
+	static bool supported(Isa isa);
+	static const char* name(Isa isa);
+
+	FftPlan() = default;
+	FftPlan(size_t size, Isa isa = detectIsa());
+
+	size_t size() const { return n; }
+	Isa isa() const { return kernelIsa; }
+
+	/**
+	 * Returns e^(-2*pi*i*k/size()) for k in [0, size()/2)
+	 */
+	std::complex<float> twiddle(size_t k) const {
+		return {twRe[n / 2 - 1 + k], twIm[n / 2 - 1 + k]};
+	}
+
+	/**
+	 * window optionally scales the real and imaginary parts of each element as it is loaded
+	 */
+	void fft(std::complex<float>* first, size_t size, const std::complex<float>* window = nullptr);
+	void ifft(std::complex<float>* first, size_t size);
+
+private:
+	size_t n = 0;
+	uint8_t numBits = 0;
+	Isa kernelIsa = Isa::scalar;
+	void (*kernel)(float*, float*, size_t, const float*, const float*) = nullptr;
+
+	// twiddle factors for every stage, the stage of length m starts at index m/2-1
+	std::vector<float> twRe;
+	std::vector<float> twIm;
+	// bit reversed indices for size n
+	std::vector<uint32_t> reversed;
+
+	// split copy of the data being transformed
+	std::vector<float> re;
+	std::vector<float> im;
+};
+
+#endif
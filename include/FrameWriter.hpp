@@ -0,0 +1,32 @@
+#pragma once
+#ifndef FRAME_WRITER_HPP
+#define FRAME_WRITER_HPP
+
+#include <cstdint>
+#include <filesystem>
+
+/**
+ * Encodes rendered frames on worker threads so that rendering does not wait on the encoder.
+ * An output of "-" writes a y4m stream to stdout, a path ending in .y4m writes a y4m stream to
+ * that file or pipe and any other path is a directory every frame is written to as a PNG.
+ */
+class FrameWriter {
+public:
+	FrameWriter() = default;
+	FrameWriter(const std::filesystem::path& output, uint32_t width, uint32_t height,
+	            uint32_t fps);
+	~FrameWriter();
+
+	FrameWriter& operator=(FrameWriter&& other) noexcept;
+
+	// copies the RGBA pixels of the next frame, blocks while the encoder is too far behind
+	void write(const unsigned char* pixels);
+	// waits for every frame to be written and rethrows any exception of the worker threads
+	void close();
+
+private:
+	class FrameWriterImpl;
+	FrameWriterImpl* impl = nullptr;
+};
+
+#endif
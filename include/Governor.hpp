@@ -0,0 +1,79 @@
+#pragma once
+#ifndef GOVERNOR_HPP
+#define GOVERNOR_HPP
+
+#include <cstddef>
+
+#include "RollingStatistics.hpp"
+
+/**
+ * Picks a quality level from the frame times, 0 being the full quality and higher levels being
+ * cheaper. Frames are judged in windows: a single window over the budget steps down, while
+ * stepping back up needs several windows in a row well under it, so that the level does not
+ * oscillate around the budget. The window after a change is ignored as it includes the cost of
+ * applying the change.
+ */
+class Governor {
+public:
+	struct Settings {
+		// milliseconds a frame may take
+		float budget = 0.f;
+		// cheapest level that can be stepped down to
+		size_t maxLevel = 0;
+		// number of frames judged together
+		size_t window = 30;
+		// fraction of the budget the frames have to stay under before stepping back up
+		float headroom = 0.7f;
+		// windows in a row with enough headroom needed to step back up
+		size_t upWindows = 4;
+	};
+
+	Governor() = default;
+	Governor(const Settings& settings) : settings(settings), frameTimes(settings.window) {}
+
+	/**
+	 * Adds the time of a frame in milliseconds, returns whether the level changed
+	 */
+	bool update(float frameTime) {
+		frameTimes.add(frameTime);
+		if (++frames < settings.window) return false;
+		frames = 0;
+
+		if (ignoreWindow) {
+			ignoreWindow = false;
+			return false;
+		}
+
+		// most of the frames have to fit, single slow frames are left to the frame pacing
+		const float time = frameTimes.percentile(0.9f);
+		if (time > settings.budget) {
+			fastWindows = 0;
+			if (currentLevel == settings.maxLevel) return false;
+			++currentLevel;
+			return ignoreWindow = true;
+		}
+
+		if (time < settings.headroom * settings.budget && currentLevel > 0) {
+			if (++fastWindows < settings.upWindows) return false;
+			fastWindows = 0;
+			--currentLevel;
+			return ignoreWindow = true;
+		}
+
+		fastWindows = 0;
+		return false;
+	}
+
+	size_t level() const { return currentLevel; }
+
+private:
+	Settings settings;
+	RollingStatistics frameTimes;
+	size_t frames = 0;
+
+	size_t currentLevel = 0;
+	size_t fastWindows = 0;
+	bool ignoreWindow = false;
+};
+
+#endif
@@ -1,7 +1,9 @@
+#include <array>
 #include <iosfwd>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
@@ -26,6 +28,7 @@ public:
 struct ModuleConfig {
 	struct Parameter {
 		uint32_t id;
+		std::string name;
 		std::variant<uint32_t, int32_t, float> value;
 	};
 
@@ -36,6 +39,22 @@ struct ModuleConfig {
 
 	std::optional<std::string> moduleName;
 	std::optional<uint32_t> vertexCount;
+	// the vertices are drawn once for every instanceSize pixels along the window's diagonal, may
+	// use the values of the parameters
+	std::optional<float> instanceSize;
+	// number of log spaced frequency bands the module expects instead of the full spectrum
+	std::optional<uint32_t> bands;
+	// fraction of the window resolution the module is rendered at before being upscaled
+	std::optional<float> renderScale;
+	// kernel the spectrum is smoothed with before the module reads it
+	std::optional<std::string> smoothing;
+	std::optional<float> smoothingLevel;
+	// whether the spectra are only bound as texel buffers or also as filtered 1D images
+	std::optional<std::string> spectrum;
+	// region the module draws to, as expressions for its x, y, width and height in pixels which
+	// may use the values of the parameters and the width and height of the module, the latter
+	// taking precedence over parameters of the same name
+	std::optional<std::array<std::string, 4>> bounds;
 
 	std::vector<Parameter> params;
 
@@ -43,3 +62,8 @@ struct ModuleConfig {
 };
 
 ModuleConfig parseConfig(std::istream& stream);
+
+// values of the parameters by name, for the expressions of the global settings, a name declared
+// more than once refers to its last declaration
+std::unordered_map<std::string, float> parameterValues(
+    const std::vector<ModuleConfig::Parameter>& params);
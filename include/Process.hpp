@@ -6,8 +6,15 @@ struct AudioData;
 
 class Process {
 public:
+	enum class Analysis { full, sliding };
+
 	struct Settings {
 		size_t size;
+		// number of frequency bins that are used, the sliding analysis only computes these
+		size_t bins;
+		Analysis analysis = Analysis::full;
+		// number of log spaced bands the bins are reduced to, 0 disables the reduction
+		size_t bands = 0;
 		float smoothingLevel;
 		float amplitude;
 		unsigned char channels;
@@ -20,6 +27,9 @@ public:
 	Process& operator=(Process&& other) noexcept;
 
 	void processSignal(AudioData& audio);
+	// transforms only the newest size samples, at most settings.size, to lower the cost of the
+	// full analysis, the output keeps the bins of the full size
+	void setFftSize(size_t size);
 
 private:
 	class ProcessImpl;
@@ -2,7 +2,9 @@
 #ifndef RENDER_HPP
 #define RENDER_HPP
 
+#include <chrono>
 #include <filesystem>
+#include <functional>
 #include <optional>
 #include <string>
 #include <utility>
@@ -31,25 +33,95 @@ public:
 		};
 
 		Window window;
+		// render into offscreen images of the window size instead of a window
+		bool headless = false;
+		// called with the RGBA pixels of every headless frame once the gpu has finished it
+		std::function<void(const unsigned char* pixels)> frameCallback;
 
 		size_t audioSize;
+		struct GpuAnalysis {
+			// samples per channel, a power of 2
+			size_t size;
+			unsigned char channels;
+			float amplitude;
+		};
+		// computes the spectra and volumes from the samples in AudioData::buffer on the gpu
+		// instead of uploading the ones computed on the cpu
+		std::optional<GpuAnalysis> gpuAnalysis;
+		// number of log spaced bands sent instead of the spectrum, 0 disables them and
+		// nullopt lets the modules decide
+		std::optional<size_t> bands;
 		float smoothingLevel = 16.f;
+		// fraction of the window resolution modules are rendered at before being upscaled,
+		// modules may override it in their config
+		float renderScale = 1.f;
 		std::vector<std::filesystem::path> moduleLocations;
 		std::vector<std::filesystem::path> modules = {1, "bars"};
 		std::filesystem::path backgroundImage;
 
 		std::optional<uint32_t> physicalDevice;
+		// file the pipeline cache is kept in between runs, empty disables it
+		std::filesystem::path pipelineCachePath;
+		// measure the gpu time of every module and layer with timestamp queries
+		bool profile = false;
 
 		bool vsync;
 	};
 
+	struct GpuTime {
+		// name of the module, layers of modules with more than one are suffixed with their number
+		std::string name;
+		// milliseconds over the recent frames
+		float min;
+		float average;
+		float p99;
+	};
+
 	Renderer() = default;
 	Renderer(const Settings& renderSettings);
 	~Renderer();
 
 	Renderer& operator=(Renderer&& other) noexcept;
 
-	bool drawFrame(const AudioData& audioData);
+	// time is passed to the shaders, by default the time since the first frame is used
+	bool drawFrame(const AudioData& audioData,
+	               std::optional<std::chrono::milliseconds> time = std::nullopt);
+	// waits for the frames still being rendered and hands them to the frame callback
+	void flush();
+
+	// number of bands the audio data should be reduced to, 0 if the full spectrum is used
+	size_t bands() const;
+
+	// whether the spectra are computed on the gpu, the gpu analysis is not used when the
+	// spectrum is reduced to bands
+	bool gpuAnalysis() const;
+	// analyses the samples of audioData.buffer on the gpu and waits for the spectra and volumes,
+	// which are written to audioData, to check the gpu analysis against the cpu
+	void analyse(AudioData& audioData);
+	// goes back to uploading the spectra computed on the cpu
+	void disableGpuAnalysis();
+
+	// whether a frame has to be drawn even if the audio has not changed, animate = false ignores
+	// modules that change over time
+	bool needsRedraw(bool animate = true) const;
+	// waits for window events or a call to wake(), returns false if the window should close,
+	// without a window it only waits for wake()
+	bool waitEvents(std::chrono::milliseconds timeout);
+	// may be called from any thread
+	void wake();
+
+	// gpu times of every module followed by their layers, empty unless profiling is enabled
+	std::vector<GpuTime> gpuTimes() const;
+	// milliseconds the gpu spent on the latest finished frame, 0 unless profiling is enabled
+	float gpuFrameTime() const;
+	// milliseconds the latest frame took on the cpu, without the time spent waiting for earlier
+	// frames and the swap chain
+	float cpuFrameTime() const;
+
+	// rerecords the frames with a different render scale and smoothing level, modules setting
+	// their own render scale keep it
+	void setQuality(float renderScale, float smoothingLevel);
+
 private:
 	class RendererImpl;
 	RendererImpl* rendererImpl = nullptr;
@@ -0,0 +1,113 @@
+#pragma once
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+/**
+ * Lock free single producer single consumer ring buffer.
+ * The producer never waits and overwrites the oldest data, the consumer reads the latest
+ * elements and retries if they were overwritten while being copied. The capacity is at least
+ * twice the size of the largest read so that retries are rare.
+ */
+template <class T>
+class RingBuffer {
+public:
+	RingBuffer() = default;
+	RingBuffer(const RingBuffer&) = delete;
+	RingBuffer& operator=(const RingBuffer&) = delete;
+
+	/**
+	 * Allocates space for reads of up to maxRead elements, only safe before the producer and
+	 * consumer start
+	 */
+	void allocate(size_t maxRead) {
+		size_t capacity = 1;
+		while (capacity < 2 * maxRead) capacity <<= 1;
+		mask = capacity - 1;
+		data.assign(capacity, T{});
+		writeIndex = 0;
+		pendingIndex = 0;
+		readIndex = 0;
+	}
+
+	// Producer
+
+	void write(const T* first, size_t count) {
+		const size_t index = writeIndex.load(std::memory_order_relaxed);
+		// announce the chunk before touching the data so that readers can tell it is in flight
+		pendingIndex.store(index + count, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for (size_t written = 0; written < count;) {
+			const size_t pos = (index + written) & mask;
+			const size_t n = std::min(count - written, data.size() - pos);
+			std::copy_n(first + written, n, data.data() + pos);
+			written += n;
+		}
+		writeIndex.store(index + count, std::memory_order_release);
+		written.notify_one();
+	}
+
+	// Consumer
+
+	bool unread() const {
+		return writeIndex.load(std::memory_order_acquire) !=
+		       readIndex.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * Waits until there is unread data or the timeout expires, returns whether there is unread
+	 * data. The producer notifies without taking the mutex so that it never blocks, a write that
+	 * lands just before the consumer starts waiting is only noticed when the timeout expires.
+	 */
+	template <class Rep, class Period>
+	bool waitUnread(const std::chrono::duration<Rep, Period>& timeout) {
+		std::unique_lock<std::mutex> lock(waitMutex);
+		return written.wait_for(lock, timeout, [&]() { return unread(); });
+	}
+
+	/**
+	 * Copies the latest count elements into first, oldest first
+	 * Returns the number of elements written since the last read
+	 */
+	size_t readLatest(T* first, size_t count) {
+		size_t end;
+		do {
+			end = writeIndex.load(std::memory_order_acquire);
+			const size_t start = end - count;
+			for (size_t read = 0; read < count;) {
+				const size_t pos = (start + read) & mask;
+				const size_t n = std::min(count - read, data.size() - pos);
+				std::copy_n(data.data() + pos, n, first + read);
+				read += n;
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			// the copy is only valid if the producer did not start wrapping around onto it
+		} while (pendingIndex.load(std::memory_order_relaxed) - end > data.size() - count);
+
+		const size_t newElements = end - readIndex.load(std::memory_order_relaxed);
+		readIndex.store(end, std::memory_order_relaxed);
+		return newElements;
+	}
+
+private:
+	std::vector<T> data;
+	size_t mask = 0;
+
+	// total number of elements written and read, wrapped with mask to index data
+	std::atomic<size_t> writeIndex{0};
+	// writeIndex after the chunk currently being written, equal to writeIndex between writes
+	std::atomic<size_t> pendingIndex{0};
+	std::atomic<size_t> readIndex{0};
+
+	std::mutex waitMutex;
+	std::condition_variable written;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+#ifndef ROLLING_STATISTICS_HPP
+#define ROLLING_STATISTICS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+/**
+ * Summarises the most recent samples of a measurement such as a frame time, older samples are
+ * overwritten once the capacity is reached
+ */
+class RollingStatistics {
+public:
+	RollingStatistics(size_t capacity = 256) : capacity(capacity) { samples.reserve(capacity); }
+
+	void add(float sample) {
+		if (samples.size() < capacity)
+			samples.push_back(sample);
+		else
+			samples[next] = sample;
+		next = (next + 1) % capacity;
+	}
+
+	bool empty() const { return samples.empty(); }
+	size_t size() const { return samples.size(); }
+
+	float min() const { return empty() ? 0.f : *std::min_element(samples.begin(), samples.end()); }
+
+	float average() const {
+		return empty() ? 0.f
+		               : std::accumulate(samples.begin(), samples.end(), 0.f) / samples.size();
+	}
+
+	// smallest sample that at least the given fraction of the samples are less than or equal to
+	float percentile(float fraction) const {
+		if (empty()) return 0.f;
+
+		std::vector<float> sorted = samples;
+		const size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+		const auto nth = sorted.begin() + std::clamp<size_t>(rank, 1, sorted.size()) - 1;
+		std::nth_element(sorted.begin(), nth, sorted.end());
+		return *nth;
+	}
+
+private:
+	size_t capacity;
+	std::vector<float> samples;
+	size_t next = 0;
+};
+
+#endif
@@ -14,6 +14,8 @@ std::pair<std::string_view, std::string_view> parseAsPair(std::string_view strin
 std::unordered_map<std::string, std::string> readConfigFile(const std::filesystem::path& filePath);
 std::unordered_map<std::string, std::string> readCmdLineArgs(int argc, const char** argv);
 std::vector<std::filesystem::path> getConfigLocations();
+// directory for files that can be regenerated, it may not exist yet
+std::filesystem::path getCacheLocation();
 std::unordered_map<std::string, std::vector<std::filesystem::path>> getModules();
 void installConfig();
 
@@ -0,0 +1,43 @@
+#pragma once
+#ifndef SILENCE_DETECTOR_HPP
+#define SILENCE_DETECTOR_HPP
+
+#include <chrono>
+
+/**
+ * Tracks how long the volume has stayed below a threshold.
+ * The detector becomes idle once the silence has lasted for the timeout and becomes active again
+ * as soon as a single chunk reaches the threshold. A timeout of zero disables idling.
+ */
+class SilenceDetector {
+public:
+	typedef std::chrono::duration<float> Duration;
+
+	SilenceDetector() = default;
+	SilenceDetector(float threshold, Duration timeout) : threshold(threshold), timeout(timeout) {}
+
+	/**
+	 * Adds a chunk of audio lasting for length with the given volume, returns whether the
+	 * detector is idle afterwards
+	 */
+	bool update(float volume, Duration length) {
+		if (volume >= threshold || timeout == Duration::zero()) {
+			silence = Duration::zero();
+			return isIdle = false;
+		}
+
+		silence += length;
+		return isIdle = (silence >= timeout);
+	}
+
+	bool idle() const { return isIdle; }
+
+private:
+	float threshold = 0.f;
+	Duration timeout = Duration::zero();
+
+	Duration silence = Duration::zero();
+	bool isIdle = false;
+};
+
+#endif
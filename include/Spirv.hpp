@@ -0,0 +1,30 @@
+#pragma once
+#ifndef SPIRV_HPP
+#define SPIRV_HPP
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Minimal SPIR-V reflection for the few questions the renderer asks about module shaders
+ */
+
+/**
+ * Returns the number of members of the uniform block at the given set and binding,
+ * 0 if the shader does not use it
+ */
+uint32_t uniformBlockMemberCount(const std::vector<char>& code, uint32_t set, uint32_t binding);
+
+/**
+ * Returns whether the shader reads the member with the given index of the uniform block at the
+ * given set and binding
+ */
+bool uniformBlockMemberUsed(const std::vector<char>& code, uint32_t set, uint32_t binding,
+                            uint32_t member);
+
+/**
+ * Returns whether the shader declares a specialization constant with the given id
+ */
+bool hasSpecializationConstant(const std::vector<char>& code, uint32_t id);
+
+#endif
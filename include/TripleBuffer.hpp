@@ -0,0 +1,60 @@
+#pragma once
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Lock free mailbox between a single producer and a single consumer.
+ * The producer fills back() and publishes it, the consumer picks up the most recently published
+ * buffer with update() and reads it through front(). Neither side ever waits for the other,
+ * buffers published before the consumer gets to them are skipped.
+ */
+template <class T>
+class TripleBuffer {
+public:
+	/**
+	 * Calls function on each of the buffers, only safe before the producer and consumer start
+	 */
+	template <class Function>
+	void forEach(Function function) {
+		for (auto& buffer : buffers) function(buffer);
+	}
+
+	// Producer
+
+	T& back() { return buffers[backIndex]; }
+
+	void publish() {
+		backIndex = middle.exchange(backIndex | dirtyBit, std::memory_order_acq_rel) & indexMask;
+	}
+
+	// Consumer
+
+	/**
+	 * Swaps in the latest published buffer, returns false if nothing was published since the
+	 * last call
+	 */
+	bool update() {
+		if (!(middle.load(std::memory_order_relaxed) & dirtyBit)) return false;
+		frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & indexMask;
+		return true;
+	}
+
+	const T& front() const { return buffers[frontIndex]; }
+
+private:
+	static constexpr uint8_t indexMask = 0b011;
+	static constexpr uint8_t dirtyBit = 0b100;
+
+	std::array<T, 3> buffers;
+
+	uint8_t backIndex = 0;
+	// index of the buffer held by neither side, with dirtyBit set when it has not been read
+	std::atomic<uint8_t> middle{1};
+	uint8_t frontIndex = 2;
+};
+
+#endif
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "AudioFile.hpp"
+
+#ifdef NDEBUG
+	#define LOCATION
+#else
+	#define STR_HELPER(x) #x
+	#define STR(x) STR_HELPER(x)
+	#define LOCATION __FILE__ ":" STR(__LINE__) ": "
+#endif
+
+namespace {
+	constexpr uint16_t FORMAT_PCM = 1;
+	constexpr uint16_t FORMAT_FLOAT = 3;
+	// the actual format is stored in the first two bytes of the sub format guid
+	constexpr uint16_t FORMAT_EXTENSIBLE = 0xFFFE;
+
+	// WAV files are always little endian
+	uint16_t readU16(const unsigned char* bytes) { return bytes[0] | bytes[1] << 8; }
+
+	uint32_t readU32(const unsigned char* bytes) {
+		return bytes[0] | bytes[1] << 8 | bytes[2] << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+	}
+
+	uint64_t readU64(const unsigned char* bytes) {
+		return readU32(bytes) | static_cast<uint64_t>(readU32(bytes + 4)) << 32;
+	}
+
+	float decodeSample(const unsigned char* bytes, uint16_t format, uint16_t bits) {
+		if (format == FORMAT_FLOAT) {
+			if (bits == 32) {
+				const uint32_t value = readU32(bytes);
+				float sample;
+				std::memcpy(&sample, &value, sizeof(sample));
+				return sample;
+			}
+
+			const uint64_t value = readU64(bytes);
+			double sample;
+			std::memcpy(&sample, &value, sizeof(sample));
+			return static_cast<float>(sample);
+		}
+
+		switch (bits) {
+			case 8:
+				return (bytes[0] - 128) / 128.f;
+			case 16:
+				return static_cast<int16_t>(readU16(bytes)) / 32768.f;
+			case 24: {
+				int32_t value = bytes[0] | bytes[1] << 8 | bytes[2] << 16;
+				if (value & 0x800000) value -= 0x1000000;
+				return value / 8388608.f;
+			}
+			default:
+				return static_cast<int32_t>(readU32(bytes)) / 2147483648.f;
+		}
+	}
+}  // namespace
+
+AudioFile::AudioFile(const std::filesystem::path& filePath) { open(filePath); }
+
+void AudioFile::open(const std::filesystem::path& filePath) {
+	std::ifstream file(filePath, std::ios::binary);
+	if (!file.is_open()) throw std::runtime_error(LOCATION "failed to open audio file!");
+
+	unsigned char header[12];
+	if (!file.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+	    std::memcmp(header, "RIFF", 4) != 0 || std::memcmp(header + 8, "WAVE", 4) != 0)
+		throw std::runtime_error(LOCATION "audio file is not a wav file!");
+
+	uint16_t format = 0;
+	uint16_t bits = 0;
+	channelCount = 0;
+	rate = 0;
+	data.clear();
+
+	unsigned char chunkHeader[8];
+	while (file.read(reinterpret_cast<char*>(chunkHeader), sizeof(chunkHeader))) {
+		const uint32_t chunkSize = readU32(chunkHeader + 4);
+
+		if (std::memcmp(chunkHeader, "fmt ", 4) == 0) {
+			if (chunkSize < 16) throw std::runtime_error(LOCATION "invalid wav format chunk!");
+
+			std::vector<unsigned char> chunk(chunkSize + (chunkSize & 1));
+			if (!file.read(reinterpret_cast<char*>(chunk.data()), chunk.size()))
+				throw std::runtime_error(LOCATION "invalid wav format chunk!");
+
+			format = readU16(chunk.data());
+			if (format == FORMAT_EXTENSIBLE && chunkSize >= 26) format = readU16(&chunk[24]);
+			channelCount = static_cast<unsigned char>(readU16(&chunk[2]));
+			rate = readU32(&chunk[4]);
+			bits = readU16(&chunk[14]);
+		} else if (std::memcmp(chunkHeader, "data", 4) == 0) {
+			const bool supported =
+			    (format == FORMAT_PCM && (bits == 8 || bits == 16 || bits == 24 || bits == 32)) ||
+			    (format == FORMAT_FLOAT && (bits == 32 || bits == 64));
+			if (!supported || channelCount == 0 || rate == 0)
+				throw std::runtime_error(LOCATION "unsupported wav format!");
+
+			const size_t sampleSize = bits / 8;
+			const size_t blockSize = sampleSize * channelCount;
+
+			// streamed files may not know the size of the data, so it is read until the end
+			// of the file or the chunk, whichever comes first
+			size_t remaining = chunkSize - chunkSize % blockSize;
+			std::vector<unsigned char> block(blockSize * 4096);
+			while (remaining > 0) {
+				file.read(reinterpret_cast<char*>(block.data()),
+				          std::min(block.size(), remaining));
+				const size_t blocks = static_cast<size_t>(file.gcount()) / blockSize;
+				if (blocks == 0) break;
+
+				for (size_t i = 0; i < blocks * channelCount; ++i)
+					data.push_back(decodeSample(&block[i * sampleSize], format, bits));
+
+				remaining -= blocks * blockSize;
+			}
+			return;
+		} else {
+			file.seekg(chunkSize + (chunkSize & 1), std::ios::cur);
+		}
+	}
+
+	throw std::runtime_error(LOCATION "wav file contains no audio data!");
+}
+
+std::vector<float> AudioFile::convert(uint32_t sampleRate, unsigned char channels) const {
+	const size_t inLength = length();
+
+	std::vector<float> mixed(inLength * channels);
+	for (size_t i = 0; i < inLength; ++i) {
+		const float* in = &data[i * channelCount];
+		float* out = &mixed[i * channels];
+		if (channels == 1) {
+			out[0] = 0.f;
+			for (size_t channel = 0; channel < channelCount; ++channel) out[0] += in[channel];
+			out[0] /= channelCount;
+		} else {
+			for (size_t channel = 0; channel < channels; ++channel)
+				out[channel] = in[std::min<size_t>(channel, channelCount - 1)];
+		}
+	}
+
+	if (sampleRate == rate || inLength == 0) return mixed;
+
+	const size_t outLength = static_cast<uint64_t>(inLength) * sampleRate / rate;
+	const double step = static_cast<double>(rate) / sampleRate;
+
+	std::vector<float> resampled(outLength * channels);
+	for (size_t i = 0; i < outLength; ++i) {
+		float* out = &resampled[i * channels];
+		if (step > 1.0) {
+			// average the samples covered by the output sample to avoid aliasing
+			const size_t begin = static_cast<size_t>(i * step);
+			const size_t end =
+			    std::clamp(static_cast<size_t>((i + 1) * step), begin + 1, inLength);
+			for (size_t channel = 0; channel < channels; ++channel) {
+				float sum = 0.f;
+				for (size_t j = begin; j < end; ++j) sum += mixed[j * channels + channel];
+				out[channel] = sum / (end - begin);
+			}
+		} else {
+			const double position = i * step;
+			const size_t j = static_cast<size_t>(position);
+			const size_t next = std::min(j + 1, inLength - 1);
+			const float t = static_cast<float>(position - j);
+			for (size_t channel = 0; channel < channels; ++channel)
+				out[channel] = (1.f - t) * mixed[j * channels + channel] +
+				               t * mixed[next * channels + channel];
+		}
+	}
+
+	return resampled;
+}
@@ -74,7 +74,8 @@ namespace {
 		throw std::invalid_argument(LOCATION "Invalid operation!");
 	}
 
-	Token extractToken(std::string_view& str, Token::Type lastTokenType) {
+	Token extractToken(std::string_view& str, Token::Type lastTokenType,
+	                   const std::unordered_map<std::string, float>& variables) {
 		if (str.front() == ',') {
 			str.remove_prefix(1);
 			return Token(Token::Type::eComma);
@@ -89,6 +90,11 @@ namespace {
 
 		auto constEnd =
 		    std::find_if_not(str.begin(), str.end(), [](char c) { return std::isalpha(c); });
+		if (auto it = variables.find(std::string(str.begin(), constEnd)); it != variables.end()) {
+			Token rtrn(Token::Type::eNumber, it->second);
+			str.remove_prefix(constEnd - str.data());
+			return rtrn;
+		}
 		if (auto it = constants.find(std::string(str.begin(), constEnd)); it != constants.end()) {
 			Token rtrn(Token::Type::eNumber, it->second);
 			str.remove_prefix(constEnd - str.data());
@@ -117,7 +123,8 @@ namespace {
 		throw std::invalid_argument(LOCATION "Unrecognized token!");
 	}
 
-	std::queue<Token> constructStack(std::string_view expr) {
+	std::queue<Token> constructStack(std::string_view expr,
+	                                 const std::unordered_map<std::string, float>& variables) {
 		while (std::isspace(expr.back())) expr.remove_suffix(1);
 
 		std::stack<Token> operatorStack;
@@ -125,7 +132,7 @@ namespace {
 		Token token;
 		while (!expr.empty()) {
 			while (std::isspace(expr.front())) expr.remove_prefix(1);
-			token = extractToken(expr, token.type);
+			token = extractToken(expr, token.type, variables);
 
 			switch (token.type) {
 				case Token::Type::eNumber:
@@ -245,10 +252,17 @@ namespace {
 
 template <class NumType>
 NumType calculate(std::string_view expr) {
-	auto tokens = constructStack(expr);
+	return calculate<NumType>(expr, {});
+}
+
+template <class NumType>
+NumType calculate(std::string_view expr, const std::unordered_map<std::string, float>& variables) {
+	auto tokens = constructStack(expr, variables);
 	return static_cast<NumType>(deconstructStack(tokens));
 }
 
 template int calculate<int>(std::string_view expr);
 template size_t calculate<size_t>(std::string_view expr);
 template float calculate<float>(std::string_view expr);
+template float calculate<float>(std::string_view expr,
+                                const std::unordered_map<std::string, float>& variables);
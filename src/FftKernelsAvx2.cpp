@@ -0,0 +1,20 @@
+#include <immintrin.h>
+
+#include "FftKernels.hpp"
+
+namespace {
+	struct Avx2Vec {
+		typedef __m256 Vec;
+		static constexpr size_t width = 8;
+		static Vec load(const float* p) { return _mm256_loadu_ps(p); }
+		static void store(float* p, Vec v) { _mm256_storeu_ps(p, v); }
+		static Vec add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+		static Vec sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+		static Vec mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+	};
+}  // namespace
+
+void fft::avx2Butterflies(float* re, float* im, size_t size, const float* twRe,
+                          const float* twIm) {
+	detail::butterflies<Avx2Vec>(re, im, size, twRe, twIm);
+}
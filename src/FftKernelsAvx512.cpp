@@ -0,0 +1,20 @@
+#include <immintrin.h>
+
+#include "FftKernels.hpp"
+
+namespace {
+	struct Avx512Vec {
+		typedef __m512 Vec;
+		static constexpr size_t width = 16;
+		static Vec load(const float* p) { return _mm512_loadu_ps(p); }
+		static void store(float* p, Vec v) { _mm512_storeu_ps(p, v); }
+		static Vec add(Vec a, Vec b) { return _mm512_add_ps(a, b); }
+		static Vec sub(Vec a, Vec b) { return _mm512_sub_ps(a, b); }
+		static Vec mul(Vec a, Vec b) { return _mm512_mul_ps(a, b); }
+	};
+}  // namespace
+
+void fft::avx512Butterflies(float* re, float* im, size_t size, const float* twRe,
+                            const float* twIm) {
+	detail::butterflies<Avx512Vec>(re, im, size, twRe, twIm);
+}
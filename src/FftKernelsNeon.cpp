@@ -0,0 +1,20 @@
+#include <arm_neon.h>
+
+#include "FftKernels.hpp"
+
+namespace {
+	struct NeonVec {
+		typedef float32x4_t Vec;
+		static constexpr size_t width = 4;
+		static Vec load(const float* p) { return vld1q_f32(p); }
+		static void store(float* p, Vec v) { vst1q_f32(p, v); }
+		static Vec add(Vec a, Vec b) { return vaddq_f32(a, b); }
+		static Vec sub(Vec a, Vec b) { return vsubq_f32(a, b); }
+		static Vec mul(Vec a, Vec b) { return vmulq_f32(a, b); }
+	};
+}  // namespace
+
+void fft::neonButterflies(float* re, float* im, size_t size, const float* twRe,
+                          const float* twIm) {
+	detail::butterflies<NeonVec>(re, im, size, twRe, twIm);
+}
@@ -0,0 +1,20 @@
+#include <immintrin.h>
+
+#include "FftKernels.hpp"
+
+namespace {
+	struct Sse2Vec {
+		typedef __m128 Vec;
+		static constexpr size_t width = 4;
+		static Vec load(const float* p) { return _mm_loadu_ps(p); }
+		static void store(float* p, Vec v) { _mm_storeu_ps(p, v); }
+		static Vec add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+		static Vec sub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+		static Vec mul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+	};
+}  // namespace
+
+void fft::sse2Butterflies(float* re, float* im, size_t size, const float* twRe,
+                          const float* twIm) {
+	detail::butterflies<Sse2Vec>(re, im, size, twRe, twIm);
+}
@@ -0,0 +1,159 @@
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+
+#include "FftKernels.hpp"
+#include "FftPlan.hpp"
+
+#ifdef NDEBUG
+	#define LOCATION
+#else
+	#define STR_HELPER(x) #x
+	#define STR(x) STR_HELPER(x)
+	#define LOCATION __FILE__ ":" STR(__LINE__) ": "
+#endif
+
+namespace {
+	uint8_t log2(size_t size) {
+		uint8_t bits = 0;
+		while ((size_t(1) << bits) < size) ++bits;
+		return bits;
+	}
+
+	fft::Kernel kernelFor(FftPlan::Isa isa) {
+		switch (isa) {
+#ifdef FFT_X86_KERNELS
+			case FftPlan::Isa::sse2:
+				return fft::sse2Butterflies;
+			case FftPlan::Isa::avx2:
+				return fft::avx2Butterflies;
+			case FftPlan::Isa::avx512:
+				return fft::avx512Butterflies;
+#endif
+#ifdef FFT_NEON_KERNELS
+			case FftPlan::Isa::neon:
+				return fft::neonButterflies;
+#endif
+			default:
+				return fft::scalarButterflies;
+		}
+	}
+}  // namespace
+
+void fft::scalarButterflies(float* re, float* im, size_t size, const float* twRe,
+                            const float* twIm) {
+	detail::butterflies<detail::ScalarVec<void>>(re, im, size, twRe, twIm);
+}
+
+FftPlan::Isa FftPlan::detectIsa() {
+	for (Isa isa : {Isa::avx512, Isa::avx2, Isa::neon, Isa::sse2})
+		if (supported(isa)) return isa;
+	return Isa::scalar;
+}
+
+bool FftPlan::supported(Isa isa) {
+	switch (isa) {
+		case Isa::scalar:
+			return true;
+#ifdef FFT_X86_KERNELS
+		case Isa::sse2:
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("sse2");
+		case Isa::avx2:
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx2");
+		case Isa::avx512:
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx512f");
+#endif
+#ifdef FFT_NEON_KERNELS
+		case Isa::neon:
+			// advanced simd is mandatory on aarch64
+			return true;
+#endif
+		default:
+			return false;
+	}
+}
+
+const char* FftPlan::name(Isa isa) {
+	switch (isa) {
+		case Isa::sse2:
+			return "SSE2";
+		case Isa::avx2:
+			return "AVX2";
+		case Isa::avx512:
+			return "AVX-512";
+		case Isa::neon:
+			return "NEON";
+		default:
+			return "scalar";
+	}
+}
+
+FftPlan::FftPlan(size_t size, Isa isa) : n(size), numBits(log2(size)) {
+	if (size == 0 || (size & (size - 1)))
+		throw std::invalid_argument(LOCATION "fft size must be a power of 2!");
+	if (!supported(isa))
+		throw std::invalid_argument(LOCATION "fft instruction set not supported by this cpu!");
+
+	kernelIsa = isa;
+	kernel = kernelFor(isa);
+
+	// computed in double precision so that no error accumulates across a stage
+	twRe.reserve(n);
+	twIm.reserve(n);
+	for (size_t m = 2; m <= n; m <<= 1) {
+		for (size_t j = 0; j < m / 2; ++j) {
+			twRe.push_back(std::cos(-2.0 * M_PI * j / m));
+			twIm.push_back(std::sin(-2.0 * M_PI * j / m));
+		}
+	}
+
+	reversed.resize(n);
+	for (size_t i = 0; i < n; ++i) {
+		uint32_t val = i;
+		uint32_t rev = 0;
+		for (uint8_t bit = 0; bit < numBits; ++bit, val >>= 1) rev = (rev << 1) | (val & 1);
+		reversed[i] = rev;
+	}
+
+	re.resize(n);
+	im.resize(n);
+}
+
+/**
+ * Performs an in place decimation in time fft
+ * Requires size to be a power of 2 no larger than the plan size
+ */
+void FftPlan::fft(std::complex<float>* first, size_t size, const std::complex<float>* window) {
+	// the reversed indices of a smaller transform are the top bits of the full size indices
+	const uint8_t shift = numBits - log2(size);
+	if (window) {
+		for (size_t i = 0; i < size; ++i) {
+			const size_t j = reversed[i] >> shift;
+			re[i] = first[j].real() * window[j].real();
+			im[i] = first[j].imag() * window[j].imag();
+		}
+	} else {
+		for (size_t i = 0; i < size; ++i) {
+			const std::complex<float>& val = first[reversed[i] >> shift];
+			re[i] = val.real();
+			im[i] = val.imag();
+		}
+	}
+
+	kernel(re.data(), im.data(), size, twRe.data(), twIm.data());
+
+	for (size_t i = 0; i < size; ++i) first[i] = {re[i], im[i]};
+}
+
+/**
+ * Performs an ifft using the fft
+ */
+void FftPlan::ifft(std::complex<float>* first, size_t size) {
+	for (size_t i = 0; i < size; ++i) first[i] = std::conj(first[i]);
+	fft(first, size);
+	const float scale = 1.f / size;
+	for (size_t i = 0; i < size; ++i) first[i] = std::conj(first[i]) * scale;
+}
@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef DISABLE_PNG
+	#include <png.h>
+#endif
+
+#include "FrameWriter.hpp"
+
+#ifdef NDEBUG
+	#define LOCATION
+#else
+	#define STR_HELPER(x) #x
+	#define STR(x) STR_HELPER(x)
+	#define LOCATION __FILE__ ":" STR(__LINE__) ": "
+#endif
+
+class FrameWriter::FrameWriterImpl {
+public:
+	FrameWriterImpl(const std::filesystem::path& output, uint32_t width, uint32_t height,
+	                uint32_t fps)
+	    : width(width), height(height) {
+		size_t workerCount = 1;
+		if (output == "-") {
+			stream = &std::cout;
+		} else if (output.extension() == ".y4m") {
+			file.open(output, std::ios::binary);
+			if (!file.is_open()) throw std::runtime_error(LOCATION "failed to open output file!");
+			stream = &file;
+		} else {
+#ifdef DISABLE_PNG
+			throw std::runtime_error(LOCATION "png output is not supported by this build!");
+#endif
+			directory = output;
+			std::filesystem::create_directories(directory);
+			// every frame is its own file, so they can be encoded in parallel
+			workerCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+		}
+
+		if (stream)
+			*stream << "YUV4MPEG2 W" << width << " H" << height << " F" << fps
+			        << ":1 Ip A1:1 C444\n";
+
+		maxQueued = 2 * workerCount;
+		workers.reserve(workerCount);
+		for (size_t i = 0; i < workerCount; ++i) workers.emplace_back(&FrameWriterImpl::run, this);
+	}
+
+	void write(const unsigned char* pixels) {
+		std::unique_lock<std::mutex> lock(mutex);
+		spaceAvailable.wait(lock, [this]() { return queue.size() < maxQueued || exceptionPtr; });
+		if (exceptionPtr) std::rethrow_exception(exceptionPtr);
+
+		std::vector<unsigned char> frame;
+		if (!freeFrames.empty()) {
+			frame = std::move(freeFrames.back());
+			freeFrames.pop_back();
+		}
+		frame.assign(pixels, pixels + 4 * width * height);
+
+		queue.emplace_back(frameCount++, std::move(frame));
+		frameAvailable.notify_one();
+	}
+
+	void close() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			closing = true;
+		}
+		frameAvailable.notify_all();
+
+		for (auto& worker : workers) worker.join();
+		workers.clear();
+
+		if (stream) stream->flush();
+		if (exceptionPtr) std::rethrow_exception(exceptionPtr);
+	}
+
+	~FrameWriterImpl() {
+		if (workers.empty()) return;
+
+		try {
+			close();
+		} catch (const std::exception& e) {
+			std::cerr << e.what() << std::endl;
+		}
+	}
+
+private:
+	uint32_t width;
+	uint32_t height;
+
+	std::filesystem::path directory;
+	std::ofstream file;
+	std::ostream* stream = nullptr;
+
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable frameAvailable;
+	std::condition_variable spaceAvailable;
+	std::deque<std::pair<size_t, std::vector<unsigned char>>> queue;
+	std::vector<std::vector<unsigned char>> freeFrames;
+	size_t maxQueued;
+	size_t frameCount = 0;
+	bool closing = false;
+	std::exception_ptr exceptionPtr = nullptr;
+
+	void run() {
+		std::vector<unsigned char> converted;
+		while (true) {
+			std::pair<size_t, std::vector<unsigned char>> frame;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				frameAvailable.wait(lock, [this]() { return !queue.empty() || closing; });
+				if (queue.empty() || exceptionPtr) return;
+
+				frame = std::move(queue.front());
+				queue.pop_front();
+			}
+
+			try {
+				if (stream)
+					writeY4m(frame.second.data(), converted);
+				else
+					writePng(frame.first, frame.second.data());
+			} catch (...) {
+				std::lock_guard<std::mutex> lock(mutex);
+				exceptionPtr = std::current_exception();
+				spaceAvailable.notify_all();
+				return;
+			}
+
+			std::lock_guard<std::mutex> lock(mutex);
+			freeFrames.push_back(std::move(frame.second));
+			spaceAvailable.notify_one();
+		}
+	}
+
+	/**
+	 * Writes the frame as limited range BT.601 YCbCr without chroma subsampling, which is what
+	 * encoders assume for y4m streams
+	 */
+	void writeY4m(const unsigned char* pixels, std::vector<unsigned char>& planes) {
+		const size_t size = static_cast<size_t>(width) * height;
+		planes.resize(3 * size);
+
+		for (size_t i = 0; i < size; ++i) {
+			const int r = pixels[4 * i];
+			const int g = pixels[4 * i + 1];
+			const int b = pixels[4 * i + 2];
+			planes[i] = static_cast<unsigned char>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+			planes[size + i] =
+			    static_cast<unsigned char>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+			planes[2 * size + i] =
+			    static_cast<unsigned char>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+		}
+
+		*stream << "FRAME\n";
+		stream->write(reinterpret_cast<const char*>(planes.data()), planes.size());
+		if (!*stream) throw std::runtime_error(LOCATION "failed to write frame!");
+	}
+
+	void writePng([[maybe_unused]] size_t index, [[maybe_unused]] const unsigned char* pixels) {
+#ifndef DISABLE_PNG
+		std::ostringstream name;
+		name << std::setw(6) << std::setfill('0') << index << ".png";
+		const std::filesystem::path path = directory / name.str();
+
+		FILE* frameFile = fopen(path.c_str(), "wb");
+		if (!frameFile) throw std::runtime_error(LOCATION "failed to open frame file!");
+
+		png_structp pPng =
+		    png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+		if (!pPng) {
+			fclose(frameFile);
+			throw std::runtime_error(LOCATION "failed to create png struct!");
+		}
+
+		png_infop pInfo = png_create_info_struct(pPng);
+		if (!pInfo) {
+			fclose(frameFile);
+			png_destroy_write_struct(&pPng, nullptr);
+			throw std::runtime_error(LOCATION "failed to create png info struct!");
+		}
+
+		std::vector<png_bytep> rows(height);
+		for (uint32_t y = 0; y < height; ++y)
+			rows[y] = const_cast<png_bytep>(pixels + 4 * static_cast<size_t>(width) * y);
+
+		if (setjmp(png_jmpbuf(pPng))) {
+			fclose(frameFile);
+			png_destroy_write_struct(&pPng, &pInfo);
+			throw std::runtime_error(LOCATION "failed to write PNG!");
+		}
+
+		png_init_io(pPng, frameFile);
+		// the window is opaque, so the alpha the modules write is dropped
+		png_set_IHDR(pPng, pInfo, width, height, 8, PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE,
+		             PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+		// favour speed, the frames are usually encoded into a video afterwards
+		png_set_compression_level(pPng, 1);
+		png_write_info(pPng, pInfo);
+		png_set_filler(pPng, 0, PNG_FILLER_AFTER);
+		png_write_image(pPng, rows.data());
+		png_write_end(pPng, nullptr);
+
+		png_destroy_write_struct(&pPng, &pInfo);
+		fclose(frameFile);
+#endif
+	}
+};
+
+FrameWriter::FrameWriter(const std::filesystem::path& output, uint32_t width, uint32_t height,
+                         uint32_t fps) {
+	impl = new FrameWriterImpl(output, width, height, fps);
+}
+
+FrameWriter& FrameWriter::operator=(FrameWriter&& other) noexcept {
+	std::swap(impl, other.impl);
+	return *this;
+}
+
+void FrameWriter::write(const unsigned char* pixels) { impl->write(pixels); }
+
+void FrameWriter::close() { impl->close(); }
+
+FrameWriter::~FrameWriter() { delete impl; }
@@ -1,3 +1,4 @@
+#include <array>
 #include <cctype>
 #include <iomanip>
 #include <istream>
@@ -6,6 +7,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
@@ -20,6 +22,36 @@ namespace {
 		if ((... || (s.get() != c))) s.setstate(std::ios::failbit);
 		return s;
 	}
+
+	// the expressions are separated by the commas outside of function calls
+	std::array<std::string, 4> parseBounds(const std::string& value, uint32_t lineNum) {
+		std::array<std::string, 4> bounds;
+		size_t count = 0;
+		int depth = 0;
+		for (char c : value) {
+			if (c == '(') ++depth;
+			if (c == ')') --depth;
+
+			if (c == ',' && depth == 0) {
+				if (++count == bounds.size()) break;
+				continue;
+			}
+			bounds[count] += c;
+		}
+
+		if (count != bounds.size() - 1)
+			throw ParseException("expected bounds to be 'x, y, width, height'", lineNum);
+
+		for (auto& bound : bounds) {
+			while (!bound.empty() && std::isspace(bound.front())) bound.erase(0, 1);
+			while (!bound.empty() && std::isspace(bound.back())) bound.pop_back();
+
+			if (bound.empty())
+				throw ParseException("expected bounds to be 'x, y, width, height'", lineNum);
+		}
+
+		return bounds;
+	}
 }  // namespace
 
 ModuleConfig parseConfig(std::istream& stream) {
@@ -28,6 +60,11 @@ ModuleConfig parseConfig(std::istream& stream) {
 	enum class Section { global, parameters, resources };
 	Section section = Section::global;
 
+	// the parameters follow the global settings, so expressions that may use them are evaluated
+	// once the whole config has been read
+	std::optional<std::pair<std::string, uint32_t>> instanceSize;
+	uint32_t boundsLine = 0;
+
 	size_t lineNum = 0;
 	std::string line_str;
 	while (std::getline(stream, line_str)) {
@@ -77,6 +114,22 @@ ModuleConfig parseConfig(std::istream& stream) {
 				config.moduleName = name;
 			else if (name == "vertexCount")
 				config.vertexCount = calculate<size_t>(value);
+			else if (name == "instanceSize")
+				instanceSize = {value, lineNum};
+			else if (name == "bands")
+				config.bands = calculate<size_t>(value);
+			else if (name == "renderScale")
+				config.renderScale = calculate<float>(value);
+			else if (name == "smoothing")
+				config.smoothing = value;
+			else if (name == "smoothingLevel")
+				config.smoothingLevel = calculate<float>(value);
+			else if (name == "spectrum")
+				config.spectrum = value;
+			else if (name == "bounds") {
+				config.bounds = parseBounds(value, lineNum);
+				boundsLine = lineNum;
+			}
 			else
 				throw ParseException("unrecognized setting '" + name + "'", lineNum);
 		} else {
@@ -103,6 +156,7 @@ ModuleConfig parseConfig(std::istream& stream) {
 				case Section::parameters: {
 					ModuleConfig::Parameter param = {};
 					param.id = id;
+					param.name = name;
 					if (type == "int")
 						param.value = calculate<int32_t>(valueStr);
 					else if (type == "float")
@@ -126,5 +180,36 @@ ModuleConfig parseConfig(std::istream& stream) {
 			}
 		}
 	}
+
+	auto variables = parameterValues(config.params);
+	if (instanceSize) {
+		try {
+			config.instanceSize = calculate<float>(instanceSize->first, variables);
+		} catch (const std::exception& e) {
+			throw ParseException(e.what(), instanceSize->second);
+		}
+	}
+
+	// the bounds are evaluated while rendering, checking them with placeholder sizes reports
+	// mistakes with their line
+	if (config.bounds) {
+		variables["width"] = 1.f;
+		variables["height"] = 1.f;
+		try {
+			for (const auto& bound : config.bounds.value()) calculate<float>(bound, variables);
+		} catch (const std::exception& e) {
+			throw ParseException(e.what(), boundsLine);
+		}
+	}
+
 	return config;
 }
+
+std::unordered_map<std::string, float> parameterValues(
+    const std::vector<ModuleConfig::Parameter>& params) {
+	std::unordered_map<std::string, float> values;
+	for (const auto& param : params)
+		values[param.name] =
+		    std::visit([](auto value) { return static_cast<float>(value); }, param.value);
+	return values;
+}
@@ -1,9 +1,12 @@
+#include <algorithm>
 #include <cmath>
 #include <complex>
-#include <numeric>
+#include <iostream>
 #include <utility>
+#include <vector>
 
 #include "Data.hpp"
+#include "FftPlan.hpp"
 #include "Process.hpp"
 
 class Process::ProcessImpl {
@@ -14,7 +17,13 @@ public:
 		amplitude = settings.amplitude;
 		smooth = settings.smoothingLevel;
 
-		if (smooth) {
+		plan = FftPlan(inputSize);
+		std::clog << "Using " << FftPlan::name(plan.isa()) << " fft kernels" << std::endl;
+
+		analysis = settings.analysis;
+		if (smooth && analysis == Analysis::sliding) {
+			createSmoothingTaps(settings.smoothingLevel);
+		} else if (smooth) {
 			// generate convolutionVec
 			convolutionVec = new std::complex<float>[inputSize / 2];
 			const float smoothingFactor = 1.f / (settings.smoothingLevel * settings.smoothingLevel);
@@ -32,15 +41,14 @@ public:
 			for (size_t i = 0; i < inputSize / 2; ++i) convolutionVec[i] /= sum;
 
 			// precompute fft
-			fft(convolutionVec, inputSize / 2);
+			plan.fft(convolutionVec, inputSize / 2);
 
 			convolutionVec[0] = convolutionVec[0].imag() + convolutionVec[0].real();
 			convolutionVec[inputSize / 4] =
 			    convolutionVec[inputSize / 4].imag() + convolutionVec[inputSize / 4].real();
-			const std::complex<float> wm =
-			    std::exp(std::complex<float>(0.f, -2.f * M_PI / inputSize));
-			std::complex<float> w = wm;
 			for (size_t r = 1; r < inputSize / 4; ++r) {
+				const std::complex<float> w = plan.twiddle(r);
+
 				auto F1 = 0.5f * (convolutionVec[r] + std::conj(convolutionVec[inputSize / 2 - r]));
 				auto G1 = std::complex<float>(0, 0.5f) *
 				          (std::conj(convolutionVec[inputSize / 2 - r]) - convolutionVec[r]);
@@ -50,200 +58,460 @@ public:
 				          (std::conj(convolutionVec[r]) - convolutionVec[inputSize / 2 - r]);
 
 				convolutionVec[r] = F1 + w * G1;
-				convolutionVec[inputSize / 2 - r] = F2 - G2 / w;
+				convolutionVec[inputSize / 2 - r] = F2 - G2 * std::conj(w);
+			}
+		}
 
-				w *= wm;
+		fftSize = inputSize;
+		createWindow();
+
+		if (analysis == Analysis::sliding) {
+			// one extra bin is needed to apply the window in the frequency domain
+			size_t bins = settings.bins ? settings.bins : inputSize / 2;
+			numBins = std::min(bins, inputSize / 2) + 1;
+
+			rotationRe.resize(numBins);
+			rotationIm.resize(numBins);
+			for (size_t k = 0; k < numBins; ++k) {
+				rotationRe[k] = std::cos(2.0 * M_PI * k / inputSize);
+				rotationIm[k] = std::sin(2.0 * M_PI * k / inputSize);
 			}
+			lBinsRe.resize(numBins);
+			lBinsIm.resize(numBins);
+			rBinsRe.resize(numBins);
+			rBinsIm.resize(numBins);
+
+			history.resize(channels * inputSize);
+			samplesSinceSync = inputSize;
 		}
 
-		wfCoeff = M_PI / (settings.size - 1);
+		if (settings.bands)
+			createBandWeights(settings.bands, settings.bins ? settings.bins : inputSize / 2);
 	}
 
-	void processSignal(AudioData& audioData) {
-		windowFunction(audioData);
-		magnitudes(audioData);
-		equalise(audioData);
-		calculateVolume(audioData);
-		if (smooth) smoothBuffer(audioData);
+	void setFftSize(size_t size) {
+		size = std::min(size, inputSize);
+		if (size == fftSize) return;
+
+		if (analysis == Analysis::sliding) {
+			std::cerr << "the fft size can not be changed by the sliding analysis!\n";
+			return;
+		}
+
+		fftSize = size;
+		createWindow();
 	}
 
-	~ProcessImpl() {
-		if (smooth) delete[] convolutionVec;
+	void processSignal(AudioData& audioData) {
+		if (analysis == Analysis::sliding) {
+			slidingUpdate(audioData);
+			slidingMagnitudes(audioData);
+		} else {
+			magnitudes(audioData);
+		}
+		if (smooth && analysis == Analysis::sliding)
+			smoothBins(audioData);
+		else if (smooth)
+			smoothBuffer(audioData);
+		if (!bandOffsets.empty()) reduceToBands(audioData);
 	}
 
+	~ProcessImpl() { delete[] convolutionVec; }
+
 private:
 	// Member variables
 
+	FftPlan plan;
+
 	// for smoothing
-	std::complex<float>* convolutionVec;
+	std::complex<float>* convolutionVec = nullptr;
 	bool smooth;
+	// the sliding analysis convolves the displayed bins directly, smoothingTaps holds the kernel
+	// by distance up to the point where it stops mattering
+	std::vector<float> smoothingTaps;
+	std::vector<float> smoothed;
 
 	size_t inputSize;
+	// the full analysis may transform only the newest fftSize samples, its bins are then spread
+	// over the bins of the whole input
+	size_t fftSize;
 	unsigned char channels;
 
 	float amplitude;
 
-	// window function
-	float wfCoeff;
+	std::vector<std::complex<float>> window;
+	std::vector<float> weights;
+
+	// sliding dft, the bins are kept in double precision to limit the error accumulated between
+	// full transforms
+	Analysis analysis;
+	size_t numBins;
+	std::vector<double> rotationRe;
+	std::vector<double> rotationIm;
+	std::vector<double> lBinsRe;
+	std::vector<double> lBinsIm;
+	std::vector<double> rBinsRe;
+	std::vector<double> rBinsIm;
+	// the samples currently in the window, historyPos is the oldest one
+	std::vector<float> history;
+	size_t historyPos;
+	size_t samplesSinceSync;
+
+	// sparse band weight matrix in compressed row format
+	std::vector<uint32_t> bandOffsets;
+	std::vector<uint32_t> bandBins;
+	std::vector<float> bandWeights;
+	std::vector<float> bands;
 
 	// Member functions
-	void windowFunction(AudioData& audioData) const {
-		if (channels == 1)
-			windowFunction(reinterpret_cast<float*>(audioData.buffer));
-		else
-			windowFunction(reinterpret_cast<std::complex<float>*>(audioData.buffer));
-	}
 
-	template <class T>
-	void windowFunction(T* audio) const {
-		for (size_t n = 0; n < inputSize; ++n) {
+	/**
+	 * Creates the hann window and equaliser weights for the current fft size
+	 */
+	void createWindow() {
+		// laid out like the samples in the buffer when it is viewed as complex numbers
+		window.resize(channels == 1 ? fftSize / 2 : fftSize);
+		const float wfCoeff = M_PI / (fftSize - 1);
+		for (size_t n = 0; n < fftSize; ++n) {
 			float tmp = std::sin(wfCoeff * n);
-			audio[n] *= tmp * tmp;
+			tmp *= tmp;
+			if (channels == 1) {
+				if (n % 2)
+					window[n / 2].imag(tmp);
+				else
+					window[n / 2].real(tmp);
+			} else {
+				window[n] = {tmp, tmp};
+			}
 		}
+
+		weights.resize(fftSize / 2);
+		for (size_t n = 0; n < fftSize / 2; ++n)
+			weights[n] = 170.f * amplitude * std::log10(2.f * n / fftSize + 1.05f) / fftSize;
 	}
 
+	/**
+	 * Computes the magnitude of each frequency bin, applies the equaliser weights and sums the
+	 * volume of each channel in a single pass. The window is applied by the fft as it loads the
+	 * samples.
+	 */
 	void magnitudes(AudioData& audioData) {
-		std::complex<float>* input = reinterpret_cast<std::complex<float>*>(audioData.buffer);
+		std::complex<float>* input = reinterpret_cast<std::complex<float>*>(
+		    audioData.buffer + channels * (inputSize - fftSize));
+		// the twiddle factors of the plan are for the full size
+		const size_t twiddleStride = inputSize / fftSize;
+		float lVolume, rVolume;
 		if (channels == 1) {
-			// input has range [0, inputSize/2)
-			fft(input, inputSize / 2);
+			// input has range [0, fftSize/2)
+			plan.fft(input, fftSize / 2, window.data());
 
-			audioData.lBuffer[0] = audioData.rBuffer[0] = input[0].imag() + input[0].real();
+			float val = (input[0].imag() + input[0].real()) * weights[0];
+			audioData.lBuffer[0] = audioData.rBuffer[0] = val;
+			lVolume = val;
 
-			const std::complex<float> wm =
-			    std::exp(std::complex<float>(0.f, -2.f * M_PI / inputSize));
-			std::complex<float> w = wm;
-			for (size_t r = 1; r < inputSize / 2; ++r) {
-				auto F = 0.5f * (input[r] + std::conj(input[inputSize / 2 - r]));
+			for (size_t r = 1; r < fftSize / 2; ++r) {
+				const std::complex<float> w = plan.twiddle(r * twiddleStride);
+				auto F = 0.5f * (input[r] + std::conj(input[fftSize / 2 - r]));
 				auto G =
-				    std::complex<float>(0, 0.5f) * (std::conj(input[inputSize / 2 - r]) - input[r]);
+				    std::complex<float>(0, 0.5f) * (std::conj(input[fftSize / 2 - r]) - input[r]);
 
-				audioData.lBuffer[r] = audioData.rBuffer[r] = std::abs(F + w * G);
-				w *= wm;
+				val = std::abs(F + w * G) * weights[r];
+				audioData.lBuffer[r] = audioData.rBuffer[r] = val;
+				lVolume += val;
 			}
+			rVolume = lVolume;
 		} else {
-			// input has range [0, inputSize)
-			fft(input, inputSize);
+			// input has range [0, fftSize)
+			plan.fft(input, fftSize, window.data());
+
+			audioData.lBuffer[0] = input[0].real() * weights[0];
+			audioData.rBuffer[0] = input[0].imag() * weights[0];
+			lVolume = audioData.lBuffer[0];
+			rVolume = audioData.rBuffer[0];
+
+			for (size_t i = 1; i < fftSize / 2; ++i) {
+				std::complex<float> val = 0.5f * (std::conj(input[fftSize - i]) + input[i]);
+				audioData.lBuffer[i] = std::abs(val) * weights[i];
+				lVolume += audioData.lBuffer[i];
+
+				val = std::complex<float>(0, 0.5f) * (std::conj(input[fftSize - i]) - input[i]);
+				audioData.rBuffer[i] = std::abs(val) * weights[i];
+				rVolume += audioData.rBuffer[i];
+			}
+		}
+		audioData.lVolume = lVolume / fftSize;
+		audioData.rVolume = rVolume / fftSize;
+
+		if (fftSize < inputSize) {
+			expandBins(audioData.lBuffer);
+			expandBins(audioData.rBuffer);
+		}
+	}
 
-			audioData.lBuffer[0] = input[0].real();
-			audioData.rBuffer[0] = input[0].imag();
+	/**
+	 * Spreads the bins of a reduced fft at the start of the buffer over the bins of the full
+	 * size, interpolating linearly between them. Runs backwards so that no bin is overwritten
+	 * before it has been read.
+	 */
+	void expandBins(float* buffer) const {
+		const size_t ratio = inputSize / fftSize;
+		const size_t last = fftSize / 2 - 1;
+		for (size_t k = inputSize / 2; k-- > 0;) {
+			const size_t bin = k / ratio;
+			const float t = static_cast<float>(k % ratio) / ratio;
+			buffer[k] = bin < last ? (1.f - t) * buffer[bin] + t * buffer[bin + 1] : buffer[last];
+		}
+	}
 
-			for (size_t i = 1; i < inputSize / 2; ++i) {
-				std::complex<float> val = 0.5f * (std::conj(input[inputSize - i]) + input[i]);
-				audioData.lBuffer[i] = std::abs(val);
+	/**
+	 * Slides the unwindowed spectrum along by the samples added since the last update,
+	 * recomputing it with a full fft once every window to stop errors from building up
+	 */
+	void slidingUpdate(AudioData& audioData) {
+		const size_t newSamples = audioData.newSamples;
+		samplesSinceSync += newSamples;
+		if (samplesSinceSync >= inputSize) {
+			resync(audioData);
+			return;
+		}
 
-				val = std::complex<float>(0, 0.5f) * (std::conj(input[inputSize - i]) - input[i]);
-				audioData.rBuffer[i] = std::abs(val);
+		const float* input = audioData.buffer + channels * (inputSize - newSamples);
+		for (size_t n = 0; n < newSamples; ++n) {
+			slide(input[channels * n] - history[channels * historyPos], lBinsRe.data(),
+			      lBinsIm.data());
+			history[channels * historyPos] = input[channels * n];
+			if (channels == 2) {
+				slide(input[2 * n + 1] - history[2 * historyPos + 1], rBinsRe.data(),
+				      rBinsIm.data());
+				history[2 * historyPos + 1] = input[2 * n + 1];
 			}
+			historyPos = (historyPos + 1) % inputSize;
 		}
 	}
 
-	void equalise(AudioData& audioData) const {
-		for (size_t n = 0; n < inputSize / 2; ++n) {
-			float weight = 170.f * amplitude * std::log10(2.f * n / inputSize + 1.05f) / inputSize;
-			audioData.lBuffer[n] *= weight;
-			audioData.rBuffer[n] *= weight;
+	/**
+	 * X_k <- (X_k + x_new - x_old) * e^(2*pi*i*k/N)
+	 */
+	void slide(double delta, double* re, double* im) const {
+		for (size_t k = 0; k < numBins; ++k) {
+			const double r = re[k] + delta;
+			re[k] = r * rotationRe[k] - im[k] * rotationIm[k];
+			im[k] = r * rotationIm[k] + im[k] * rotationRe[k];
 		}
 	}
 
-	void calculateVolume(AudioData& audioData) const {
-		audioData.lVolume =
-		    std::accumulate(audioData.lBuffer, audioData.lBuffer + inputSize / 2, 0.f) / inputSize;
-		audioData.rVolume =
-		    std::accumulate(audioData.rBuffer, audioData.rBuffer + inputSize / 2, 0.f) / inputSize;
+	void resync(AudioData& audioData) {
+		std::copy(audioData.buffer, audioData.buffer + channels * inputSize, history.begin());
+		historyPos = 0;
+		samplesSinceSync = 0;
+
+		std::complex<float>* input = reinterpret_cast<std::complex<float>*>(audioData.buffer);
+		if (channels == 1) {
+			plan.fft(input, inputSize / 2);
+
+			lBinsRe[0] = input[0].real() + input[0].imag();
+			lBinsIm[0] = 0.0;
+			for (size_t r = 1; r < numBins; ++r) {
+				if (r == inputSize / 2) {
+					lBinsRe[r] = input[0].real() - input[0].imag();
+					lBinsIm[r] = 0.0;
+					break;
+				}
+				const std::complex<float> w = plan.twiddle(r);
+				auto F = 0.5f * (input[r] + std::conj(input[inputSize / 2 - r]));
+				auto G =
+				    std::complex<float>(0, 0.5f) * (std::conj(input[inputSize / 2 - r]) - input[r]);
+				const std::complex<float> val = F + w * G;
+				lBinsRe[r] = val.real();
+				lBinsIm[r] = val.imag();
+			}
+		} else {
+			plan.fft(input, inputSize);
+
+			for (size_t i = 0; i < numBins; ++i) {
+				const std::complex<float> conj = std::conj(input[(inputSize - i) % inputSize]);
+				std::complex<float> val = 0.5f * (conj + input[i]);
+				lBinsRe[i] = val.real();
+				lBinsIm[i] = val.imag();
+
+				val = std::complex<float>(0, 0.5f) * (conj - input[i]);
+				rBinsRe[i] = val.real();
+				rBinsIm[i] = val.imag();
+			}
+		}
 	}
 
 	/**
-	 * Performs a fast convolution between the input audio and convolutionVec
+	 * Applies the hann window as the convolution {-1/4, 1/2, -1/4} over neighbouring bins,
+	 * followed by the same weighting and volume calculation as magnitudes
 	 */
-	void smoothBuffer(AudioData& audioData) {
-		auto input = reinterpret_cast<std::complex<float>*>(audioData.buffer);
-		for (size_t i = 0; i < inputSize / 2; ++i) {
-			input[i] = {audioData.lBuffer[i], audioData.rBuffer[i]};
-			input[i + inputSize / 2] = {audioData.lBuffer[inputSize / 2 - i - 1],
-			                            audioData.rBuffer[inputSize / 2 - i - 1]};
-		}
-		fft(input, inputSize);
-
-		input[0] *= convolutionVec[0];
-		for (size_t i = 1; i < inputSize / 2; ++i) {
-			input[i] *= convolutionVec[i];
-			input[inputSize - i] *= convolutionVec[i];
+	void slidingMagnitudes(AudioData& audioData) const {
+		float lVolume = 0.f, rVolume = 0.f;
+		for (size_t k = 0; k < numBins - 1; ++k) {
+			audioData.lBuffer[k] = windowedMagnitude(lBinsRe.data(), lBinsIm.data(), k) * weights[k];
+			lVolume += audioData.lBuffer[k];
 		}
-		ifft(input, inputSize);
-		for (size_t i = 0; i < inputSize / 2; ++i) {
-			audioData.lBuffer[i] = input[i].real();
-			audioData.rBuffer[i] = input[i].imag();
+		if (channels == 2) {
+			for (size_t k = 0; k < numBins - 1; ++k) {
+				audioData.rBuffer[k] =
+				    windowedMagnitude(rBinsRe.data(), rBinsIm.data(), k) * weights[k];
+				rVolume += audioData.rBuffer[k];
+			}
+		} else {
+			std::copy(audioData.lBuffer, audioData.lBuffer + numBins - 1, audioData.rBuffer);
+			rVolume = lVolume;
 		}
+		std::fill(audioData.lBuffer + numBins - 1, audioData.lBuffer + inputSize / 2, 0.f);
+		std::fill(audioData.rBuffer + numBins - 1, audioData.rBuffer + inputSize / 2, 0.f);
+
+		audioData.lVolume = lVolume / inputSize;
+		audioData.rVolume = rVolume / inputSize;
 	}
 
-	// Static member functions
+	float windowedMagnitude(const double* re, const double* im, size_t k) const {
+		// the spectrum of a real signal is conjugate symmetric, so X_-1 = conj(X_1) and the dc bin
+		// is real, its sign is kept to match the full analysis
+		if (k == 0) return 0.5 * re[0] - 0.5 * re[1];
+		return std::hypot(0.5 * re[k] - 0.25 * (re[k - 1] + re[k + 1]),
+		                  0.5 * im[k] - 0.25 * (im[k - 1] + im[k + 1]));
+	}
 
 	/**
-	 * Performs an ifft using the fft
-	 * Requires the input buffer size to be a power of 2
+	 * Builds triangular filters with log spaced centres between the first bin and the last
+	 * displayed one. Each filter reaches the centres of its neighbours and is at least a bin wide
+	 * on either side, so that the narrow low bands interpolate between bins instead of missing
+	 * them. The weights of each band sum to 1.
 	 */
+	void createBandWeights(size_t numBands, size_t bins) {
+		bins = std::min(bins, inputSize / 2);
+
+		std::vector<double> centres(numBands + 2);
+		for (size_t b = 0; b < centres.size(); ++b)
+			centres[b] =
+			    std::pow(static_cast<double>(bins - 1), static_cast<double>(b) / (numBands + 1));
+
+		bandOffsets.reserve(numBands + 1);
+		bandOffsets.push_back(0);
+		for (size_t b = 1; b <= numBands; ++b) {
+			const double centre = centres[b];
+			const double lower = std::min(centres[b - 1], centre - 1.0);
+			const double upper = std::max(centres[b + 1], centre + 1.0);
+
+			const size_t first = bandBins.size();
+			float sum = 0.f;
+			for (size_t bin = std::max(std::ceil(lower), 1.0); bin < upper && bin < bins; ++bin) {
+				const float weight = bin < centre ? (bin - lower) / (centre - lower)
+				                                  : (upper - bin) / (upper - centre);
+				if (weight <= 0.f) continue;
+				bandBins.push_back(bin);
+				bandWeights.push_back(weight);
+				sum += weight;
+			}
+			for (size_t i = first; i < bandWeights.size(); ++i) bandWeights[i] /= sum;
+			bandOffsets.push_back(bandBins.size());
+		}
 
-	static void ifft(std::complex<float>* first, const size_t size) {
-		for (size_t i = 0; i < size; ++i) first[i] = std::conj(first[i]);
-		fft(first, size);
-		for (size_t i = 0; i < size; ++i) first[i] = std::conj(first[i]) / static_cast<float>(size);
+		bands.resize(numBands);
+	}
+
+	void reduceToBands(AudioData& audioData) {
+		reduceToBands(audioData.lBuffer);
+		if (channels == 2)
+			reduceToBands(audioData.rBuffer);
+		else
+			std::copy(audioData.lBuffer, audioData.lBuffer + bands.size(), audioData.rBuffer);
+	}
+
+	void reduceToBands(float* buffer) {
+		for (size_t b = 0; b < bands.size(); ++b) {
+			float val = 0.f;
+			for (uint32_t i = bandOffsets[b]; i < bandOffsets[b + 1]; ++i)
+				val += bandWeights[i] * buffer[bandBins[i]];
+			bands[b] = val;
+		}
+		std::copy(bands.begin(), bands.end(), buffer);
 	}
 
 	/**
-	 * Performs bit reverse fft
-	 * Requires the input buffer size to be a power of 2
+	 * Creates the kernel used by smoothBins, the same one that convolutionVec holds the fft of
 	 */
-
-	static void fft(std::complex<float>* first, const size_t size) {
-		bitReverseShuffle(first, size);
-		for (size_t m = 2; m <= size; m <<= 1) {
-			const std::complex<float> wm = std::exp(std::complex<float>(0.f, -2.0 * M_PI / m));
-			for (size_t k = 0; k < size; k += m) {
-				std::complex<float> w = 1;
-				for (size_t j = 0; 2 * j < m; ++j, w *= wm) {
-					const std::complex<float> t = w * first[k + j + m / 2];
-					const std::complex<float> u = first[k + j];
-					first[k + j] = u + t;
-					first[k + j + m / 2] = u - t;
-				}
-			}
+	void createSmoothingTaps(float smoothingLevel) {
+		const float smoothingFactor = 1.f / (smoothingLevel * smoothingLevel);
+		std::vector<float> taps(inputSize / 2 + 1);
+		float sum = 0.f;
+		for (size_t d = 0; d < taps.size(); ++d) {
+			const float dx = static_cast<float>(d) / inputSize;
+			taps[d] = std::exp(-dx * dx * smoothingFactor) +
+			          std::exp(-(1.f - dx) * (1.f - dx) * smoothingFactor);
+			// every distance but 0 and inputSize/2 appears on both sides of a bin
+			sum += d == 0 || d == inputSize / 2 ? taps[d] : 2.f * taps[d];
 		}
+
+		size_t radius = 1;
+		while (radius < taps.size() && taps[radius] > 1e-6f * taps[0]) ++radius;
+		smoothingTaps.resize(radius);
+		for (size_t d = 0; d < radius; ++d) smoothingTaps[d] = taps[d] / sum;
+
+		smoothed.resize(inputSize / 2);
+	}
+
+	void smoothBins(AudioData& audioData) {
+		smoothBins(audioData.lBuffer);
+		if (channels == 2)
+			smoothBins(audioData.rBuffer);
+		else
+			std::copy(audioData.lBuffer, audioData.lBuffer + numBins - 1, audioData.rBuffer);
 	}
 
-	static void bitReverseShuffle(std::complex<float>* first, size_t size) {
-/**
- * num_bits = log2(size).
- * here i am assuming that the fft size is less than 2^16,
- * that it is not 0 and that it is a power of 2
- */
-#ifdef __builtin_ctz
-		uint8_t numBits = __builtin_ctz(size);  // count number of trailing 0s
-#else
-		uint8_t numBits = 15;
-		if (size & 0x00FF) numBits -= 8;
-		if (size & 0x0F0F) numBits -= 4;
-		if (size & 0x3333) numBits -= 2;
-		if (size & 0x5555) numBits -= 1;
-#endif
-
-		for (size_t i = 0; i < size; ++i) {
-			size_t j = reverseBits(i, numBits);
-			if (i < j) std::swap(first[i], first[j]);
+	/**
+	 * Convolves the displayed bins with the smoothing kernel like smoothBuffer does, the spectrum
+	 * is mirrored at the dc and nyquist bins and the bins that aren't displayed are zero. This
+	 * costs the number of displayed bins times the kernel width instead of two transforms of the
+	 * whole input.
+	 */
+	void smoothBins(float* buffer) {
+		const size_t bins = numBins - 1;
+		const size_t radius = smoothingTaps.size();
+		const size_t half = inputSize / 2;
+		for (size_t k = 0; k < bins; ++k) {
+			float val = 0.f;
+			const size_t first = k + 1 > radius ? k + 1 - radius : 0;
+			for (size_t j = first; j < std::min(k + radius, bins); ++j)
+				val += smoothingTaps[j > k ? j - k : k - j] * buffer[j];
+			// the mirrored bin j lies k + j + 1 bins away, or inputSize minus that around the
+			// nyquist bin
+			for (size_t j = 0; j < bins && k + j + 1 <= half && k + j + 1 < radius; ++j)
+				val += smoothingTaps[k + j + 1] * buffer[j];
+			const size_t mirrored = std::max(half - k, inputSize - k - std::min(radius, half));
+			for (size_t j = mirrored; j < bins; ++j)
+				val += smoothingTaps[inputSize - k - j - 1] * buffer[j];
+			smoothed[k] = val;
 		}
+		std::copy(smoothed.begin(), smoothed.begin() + bins, buffer);
 	}
 
 	/**
-	 * Reverses the first n bits in val
+	 * Performs a fast convolution between the input audio and convolutionVec
 	 */
-	constexpr static size_t reverseBits(size_t val, uint8_t n) {
-		size_t reversed = 0;
-		for (uint8_t i = 0; i < n; ++i) {
-			reversed <<= 1;
-			reversed |= val & 1;
-			val >>= 1;
+	void smoothBuffer(AudioData& audioData) {
+		auto input = reinterpret_cast<std::complex<float>*>(audioData.buffer);
+		for (size_t i = 0; i < inputSize / 2; ++i) {
+			input[i] = {audioData.lBuffer[i], audioData.rBuffer[i]};
+			input[i + inputSize / 2] = {audioData.lBuffer[inputSize / 2 - i - 1],
+			                            audioData.rBuffer[inputSize / 2 - i - 1]};
+		}
+		plan.fft(input, inputSize);
+
+		input[0] *= convolutionVec[0];
+		for (size_t i = 1; i < inputSize / 2; ++i) {
+			input[i] *= convolutionVec[i];
+			input[inputSize - i] *= convolutionVec[i];
+		}
+		plan.ifft(input, inputSize);
+		for (size_t i = 0; i < inputSize / 2; ++i) {
+			audioData.lBuffer[i] = input[i].real();
+			audioData.rBuffer[i] = input[i].imag();
 		}
-		return reversed;
 	}
 };
 
@@ -256,4 +524,6 @@ Process& Process::operator=(Process&& other) noexcept {
 
 void Process::processSignal(AudioData& audioData) { impl->processSignal(audioData); }
 
+void Process::setFftSize(size_t size) { impl->setFftSize(size); }
+
 Process::~Process() { delete impl; }
@@ -4,7 +4,6 @@
 #include <cstdlib>
 #include <exception>
 #include <iostream>
-#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <thread>
@@ -17,6 +16,7 @@
 
 #include "Audio.hpp"
 #include "Data.hpp"
+#include "RingBuffer.hpp"
 
 #ifdef NDEBUG
 	#define LOCATION
@@ -29,7 +29,6 @@
 class AudioSampler::AudioSamplerImpl {
 public:
 	std::atomic<bool> running;
-	std::atomic<bool> modified;
 	std::atomic<int> ups;
 
 	AudioSamplerImpl(const Settings& audioSettings) {
@@ -49,22 +48,18 @@ public:
 		running = false;
 		audioThread.join();
 
-		for (uint32_t i = 0; i < settings.bufferSize / settings.sampleSize; ++i)
-			delete[] ppAudioBuffer[i];
-
-		delete[] ppAudioBuffer;
 		delete[] pSampleBuffer;
 
 		pa_simple_free(s);
 	}
 
-	void copyData(AudioData& audioData) {
-		audioMutexLock.lock();
-		for (size_t i = 0; i < settings.bufferSize; ++i)
-			audioData.buffer[i] = ppAudioBuffer[i / settings.sampleSize][i % settings.sampleSize];
-		audioMutexLock.unlock();
+	bool modified() const { return audioBuffer.unread(); }
+
+	bool waitForData(std::chrono::milliseconds timeout) { return audioBuffer.waitUnread(timeout); }
 
-		modified = false;
+	void copyData(AudioData& audioData) {
+		audioData.newSamples =
+		    audioBuffer.readLatest(audioData.buffer, settings.bufferSize) / settings.channels;
 	}
 
 	void rethrowExceptions() {
@@ -73,13 +68,9 @@ public:
 
 private:
 	// data
-	float** ppAudioBuffer;
+	RingBuffer<float> audioBuffer;
 	float* pSampleBuffer;
 
-	// multithreading
-
-	std::mutex audioMutexLock;
-
 	// used to handle exceptions
 	std::exception_ptr exceptionPtr = nullptr;
 
@@ -103,15 +94,10 @@ private:
 		settings.sinkName = audioSettings.sinkName;
 
 		running = true;
-		modified = false;
 		ups = settings.sampleRate / settings.sampleSize;
 
 		pSampleBuffer = new float[settings.sampleSize];
-
-		ppAudioBuffer = new float*[settings.bufferSize / settings.sampleSize];
-
-		for (uint32_t i = 0; i < settings.bufferSize / settings.sampleSize; ++i)
-			ppAudioBuffer[i] = new float[settings.sampleSize];
+		audioBuffer.allocate(settings.bufferSize);
 
 		if (settings.sinkName.empty()) getDefaultSink();
 
@@ -128,12 +114,7 @@ private:
 				throw std::runtime_error(std::string(LOCATION "pa_simple_read() failed: ") +
 				                         pa_strerror(error));
 
-			audioMutexLock.lock();
-			std::swap(ppAudioBuffer[0], pSampleBuffer);
-			for (size_t i = 1; i < settings.bufferSize / settings.sampleSize; ++i)
-				std::swap(ppAudioBuffer[i - 1], ppAudioBuffer[i]);
-			audioMutexLock.unlock();
-			this->modified = true;
+			audioBuffer.write(pSampleBuffer, settings.sampleSize);
 
 			++numUpdates;
 			std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
@@ -223,7 +204,11 @@ AudioSampler& AudioSampler::operator=(AudioSampler&& other) noexcept {
 
 bool AudioSampler::running() const { return audioSamplerImpl->running; }
 
-bool AudioSampler::modified() const { return audioSamplerImpl->modified; }
+bool AudioSampler::modified() const { return audioSamplerImpl->modified(); }
+
+bool AudioSampler::waitForData(std::chrono::milliseconds timeout) {
+	return audioSamplerImpl->waitForData(timeout);
+}
 
 int AudioSampler::ups() const { return audioSamplerImpl->ups; }
 
@@ -4,7 +4,6 @@
 #include <cstdlib>
 #include <exception>
 #include <iostream>
-#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -16,6 +15,7 @@
 
 #include "Audio.hpp"
 #include "Data.hpp"
+#include "RingBuffer.hpp"
 
 #ifdef NDEBUG
 	#define LOCATION
@@ -28,7 +28,6 @@
 class AudioSampler::AudioSamplerImpl {
 public:
 	std::atomic<bool> running;
-	std::atomic<bool> modified{false};
 	std::atomic<int> ups;
 
 	AudioSamplerImpl(const Settings& audioSettings) {
@@ -41,9 +40,7 @@ public:
 		ups = settings.sampleRate / settings.sampleSize;
 
 		pSampleBuffer = new float[settings.sampleSize];
-		ppAudioBuffer = new float*[settings.bufferSize / settings.sampleSize];
-		for (uint32_t i = 0; i < settings.bufferSize / settings.sampleSize; ++i)
-			ppAudioBuffer[i] = new float[settings.sampleSize];
+		audioBuffer.allocate(settings.bufferSize);
 
 		initPulse();
 
@@ -65,19 +62,16 @@ public:
 
 		pa_threaded_mainloop_free(mainloop);
 
-		for (uint32_t i = 0; i < settings.bufferSize / settings.sampleSize; ++i)
-			delete[] ppAudioBuffer[i];
-
-		delete[] ppAudioBuffer;
 		delete[] pSampleBuffer;
 	}
 
+	bool modified() const { return audioBuffer.unread(); }
+
+	bool waitForData(std::chrono::milliseconds timeout) { return audioBuffer.waitUnread(timeout); }
+
 	void copyData(AudioData& audioData) {
-		audioMutexLock.lock();
-		modified.store(false, std::memory_order_relaxed);
-		for (size_t i = 0; i < settings.bufferSize; ++i)
-			audioData.buffer[i] = ppAudioBuffer[i / settings.sampleSize][i % settings.sampleSize];
-		audioMutexLock.unlock();
+		audioData.newSamples =
+		    audioBuffer.readLatest(audioData.buffer, settings.bufferSize) / settings.channels;
 	}
 
 	void rethrowExceptions() {
@@ -86,14 +80,10 @@ public:
 
 private:
 	// data
-	float** ppAudioBuffer;
+	RingBuffer<float> audioBuffer;
 	float* pSampleBuffer;
 	size_t bufPos = 0;
 
-	// multithreading
-
-	std::mutex audioMutexLock;
-
 	// used to handle exceptions
 	std::exception_ptr exceptionPtr = nullptr;
 
@@ -176,12 +166,7 @@ private:
 		// copy data
 		for (size_t i = 0; i < size; ++i, ++audio->bufPos) {
 			if (audio->bufPos == audio->settings.sampleSize) {
-				audio->audioMutexLock.lock();
-				audio->modified.store(true, std::memory_order_relaxed);
-				std::swap(audio->ppAudioBuffer[0], audio->pSampleBuffer);
-				for (size_t i = 1; i * audio->settings.sampleSize < audio->settings.bufferSize; ++i)
-					std::swap(audio->ppAudioBuffer[i - 1], audio->ppAudioBuffer[i]);
-				audio->audioMutexLock.unlock();
+				audio->audioBuffer.write(audio->pSampleBuffer, audio->settings.sampleSize);
 
 				++numUpdates;
 				auto currentTime = std::chrono::steady_clock::now();
@@ -253,8 +238,10 @@ AudioSampler& AudioSampler::operator=(AudioSampler&& other) noexcept {
 
 bool AudioSampler::running() const { return audioSamplerImpl->running; }
 
-bool AudioSampler::modified() const {
-	return audioSamplerImpl->modified.load(std::memory_order_acquire);
+bool AudioSampler::modified() const { return audioSamplerImpl->modified(); }
+
+bool AudioSampler::waitForData(std::chrono::milliseconds timeout) {
+	return audioSamplerImpl->waitForData(timeout);
 }
 
 int AudioSampler::ups() const { return audioSamplerImpl->ups.load(std::memory_order_relaxed); }
@@ -5,14 +5,20 @@
 #include <array>
 #include <cctype>
 #include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <limits>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
@@ -22,6 +28,8 @@
 #include "ModuleConfig.hpp"
 #include "NativeWindowHints.hpp"
 #include "Render.hpp"
+#include "RollingStatistics.hpp"
+#include "Spirv.hpp"
 #include "Version.hpp"
 
 #ifdef NDEBUG
@@ -92,6 +100,21 @@ namespace {
 
 			throw std::runtime_error(LOCATION "failed to find suitable memory type!");
 		}
+
+		/**
+		 * Returns true if all of the memory is local to the device, as on integrated gpus, where
+		 * host visible memory is as fast for the gpu to read as any other memory
+		 */
+		bool unifiedMemory() const {
+			VkPhysicalDeviceMemoryProperties memProperties;
+			vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+
+			for (uint32_t i = 0; i < memProperties.memoryHeapCount; ++i)
+				if (!(memProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT))
+					return false;
+
+			return true;
+		}
 	};
 
 	struct Image {
@@ -99,8 +122,8 @@ namespace {
 
 		VkImage image;
 		VkDeviceMemory memory;
-		VkImageView view;
-		VkSampler sampler;
+		VkImageView view = VK_NULL_HANDLE;
+		VkSampler sampler = VK_NULL_HANDLE;
 
 		Image() = default;
 
@@ -170,6 +193,32 @@ namespace {
 		resourceType rsrc;
 	};
 
+	// gaussian and mcat are the kernels of smoothing.glsl, shader leaves the smoothing to the
+	// module's shaders
+	enum class SmoothingKernel : int32_t { gaussian, mcat, shader };
+
+	struct SmoothingPushConstants {
+		float level;
+		SmoothingKernel kernel;
+	};
+
+	// every dispatch of the gpu analysis runs one of its steps, offsets are in floats
+	enum class AnalysisStep : uint32_t { window, butterfly, magnitude, volume };
+
+	struct AnalysisPushConstants {
+		AnalysisStep step;
+		uint32_t stage;
+		uint32_t size;
+		uint32_t channels;
+		uint32_t audioSize;
+		uint32_t samples;
+		uint32_t lAudio;
+		uint32_t rAudio;
+		uint32_t uniformStride;
+		uint32_t moduleCount;
+		float amplitude;
+	};
+
 	struct Module {
 		std::filesystem::path location;
 
@@ -181,6 +230,38 @@ namespace {
 		// Name of the fragment shader function to call
 		std::string moduleName = "main";
 		uint32_t vertexCount = 6;
+		// pixels along the diagonal of the extent the module is rendered at per instance, the
+		// vertices are drawn once when not set
+		std::optional<float> instanceSize;
+		// expressions for the region of the extent the module draws to, nothing outside of it is
+		// rasterized
+		std::optional<std::array<std::string, 4>> bounds;
+		// values of the parameters by name, which the bounds may use
+		std::unordered_map<std::string, float> parameters;
+		std::optional<uint32_t> bands;
+		// whether the shaders read the window size from specialization constants 2 and 3
+		// instead of the uniform block, their pipelines have to be rebuilt when it changes
+		bool extentDependent = false;
+		// fraction of the window resolution the module is rendered at, below 1 it is rendered
+		// into images of its own for each frame in flight which are upscaled into the window
+		float renderScale = 1.f;
+		// render scale set by the module's config, which takes precedence over the global one
+		std::optional<float> fixedRenderScale;
+		std::array<Image, MAX_FRAMES_IN_FLIGHT> scaledImages;
+		std::array<VkFramebuffer, MAX_FRAMES_IN_FLIGHT> scaledFramebuffers;
+		std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> upscaleDescriptorSets;
+		SmoothingKernel smoothingKernel = SmoothingKernel::gaussian;
+		// smoothing level set by the module's config, which takes precedence over the global one
+		std::optional<float> fixedSmoothingLevel;
+		// spectra the module reads, 0 is the unsmoothed audio and the others are the outputs of
+		// the smoothing passes
+		size_t spectra = 0;
+		// whether the module also reads its spectra as 1D images at bindings 4 and 5, which are
+		// sampled with linear filtering instead of being fetched from the texel buffers. Its
+		// constant 5 says whether it may, the images can't be filtered on every device.
+		bool spectrumImages = false;
+
+		bool scaled() const { return renderScale < 1.f; }
 
 		static void destroy(VkDevice device, Module& module) {
 			for (auto& layer : module.layers) {
@@ -197,7 +278,7 @@ namespace {
 
 		VkBuffer buffer;
 		VkDeviceMemory memory;
-		VkBufferView view = VK_NULL_HANDLE;
+		std::vector<VkBufferView> views;
 
 		VkDeviceSize size;
 
@@ -232,16 +313,23 @@ namespace {
 			vkBindBufferMemory(device.device, buffer, memory, 0);
 		}
 
-		void createBufferView(VkFormat format) {
+		/**
+		 * Creates a view of part of the buffer, the view is destroyed along with the buffer
+		 */
+		VkBufferView createBufferView(VkFormat format, VkDeviceSize offset, VkDeviceSize range) {
 			VkBufferViewCreateInfo viewInfo = {};
 			viewInfo.sType = VK_STRUCTURE_TYPE_BUFFER_VIEW_CREATE_INFO;
 			viewInfo.buffer = buffer;
 			viewInfo.format = format;
-			viewInfo.offset = 0;
-			viewInfo.range = size;
+			viewInfo.offset = offset;
+			viewInfo.range = range;
 
+			VkBufferView view;
 			if (vkCreateBufferView(device.device, &viewInfo, nullptr, &view) != VK_SUCCESS)
 				throw std::runtime_error(LOCATION "failed to create buffer view!");
+
+			views.push_back(view);
+			return view;
 		}
 
 		void* mapMemory() {
@@ -253,16 +341,48 @@ namespace {
 		void unmapMemory() { vkUnmapMemory(device.device, memory); }
 
 		static void destroy(Buffer& buffer) {
-			vkDestroyBufferView(buffer.device.device, buffer.view, nullptr);
+			for (auto view : buffer.views) vkDestroyBufferView(buffer.device.device, view, nullptr);
 			vkDestroyBuffer(buffer.device.device, buffer.buffer, nullptr);
 			vkFreeMemory(buffer.device.device, buffer.memory, nullptr);
 		}
 	};
 
+	/**
+	 * Written in front of the pipeline cache data so that caches from a different device or
+	 * driver are discarded instead of being handed to the driver
+	 */
+	struct PipelineCacheHeader {
+		char magic[4] = {'V', 'K', 'P', 'C'};
+		uint32_t vendorID;
+		uint32_t deviceID;
+		uint32_t driverVersion;
+		uint8_t uuid[VK_UUID_SIZE];
+		uint64_t dataSize;
+
+		PipelineCacheHeader() = default;
+
+		PipelineCacheHeader(const VkPhysicalDeviceProperties& properties, uint64_t dataSize) {
+			vendorID = properties.vendorID;
+			deviceID = properties.deviceID;
+			driverVersion = properties.driverVersion;
+			std::copy_n(properties.pipelineCacheUUID, VK_UUID_SIZE, uuid);
+			this->dataSize = dataSize;
+		}
+
+		bool matches(const PipelineCacheHeader& other) const {
+			return std::equal(magic, magic + sizeof(magic), other.magic) &&
+			       vendorID == other.vendorID && deviceID == other.deviceID &&
+			       driverVersion == other.driverVersion &&
+			       std::equal(uuid, uuid + VK_UUID_SIZE, other.uuid);
+		}
+	};
+
 	struct UniformBufferObject {
 		float lVolume;
 		float rVolume;
 		uint32_t time;
+		uint32_t width;
+		uint32_t height;
 	};
 }  // namespace
 
@@ -271,21 +391,31 @@ public:
 	RendererImpl(const Settings& renderSettings) {
 		settings = renderSettings;
 
-		initWindow();
+		if (!settings.headless) initWindow();
 		initVulkan();
 	}
 
-	bool drawFrame(const AudioData& audioData) {
+	bool drawFrame(const AudioData& audioData, std::optional<std::chrono::milliseconds> time) {
+		if (settings.headless) return drawOffscreenFrame(audioData, time);
+
+		const auto frameStart = std::chrono::steady_clock::now();
+
 		glfwPollEvents();
 		if (glfwWindowShouldClose(window)) return false;
+		damaged = false;
 
+		auto waitStart = std::chrono::steady_clock::now();
 		vkWaitForFences(device.device, 1, &inFlightFences[currentFrame], VK_TRUE,
 		                std::numeric_limits<uint64_t>::max());
+		auto waited = std::chrono::steady_clock::now() - waitStart;
+		collectTimestamps(currentFrame);
 
 		uint32_t imageIndex;
+		waitStart = std::chrono::steady_clock::now();
 		VkResult result = vkAcquireNextImageKHR(
 		    device.device, swapChain, std::numeric_limits<uint64_t>::max(),
 		    imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
+		waited += std::chrono::steady_clock::now() - waitStart;
 
 		switch (result) {
 			case VK_SUCCESS:
@@ -298,7 +428,7 @@ public:
 				throw std::runtime_error(LOCATION "failed to acquire swap chain image!");
 		}
 
-		updateAudioBuffers(audioData, imageIndex);
+		updateAudioBuffers(audioData, currentFrame, time);
 
 		VkSubmitInfo submitInfo = {};
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -310,7 +440,7 @@ public:
 		submitInfo.pWaitDstStageMask = waitStages;
 
 		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &commandBuffers[imageIndex];
+		submitInfo.pCommandBuffers = &commandBuffers[currentFrame][imageIndex];
 
 		VkSemaphore signalSemaphores[] = {renderFinishedSemaphores[currentFrame]};
 		submitInfo.signalSemaphoreCount = 1;
@@ -321,6 +451,7 @@ public:
 		if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]) !=
 		    VK_SUCCESS)
 			throw std::runtime_error(LOCATION "failed to submit draw command buffer!");
+		queriesPending[currentFrame] = settings.profile;
 
 		VkPresentInfoKHR presentInfo = {};
 		presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -344,32 +475,283 @@ public:
 				throw std::runtime_error(LOCATION "failed to present swap chain image!");
 		}
 
+		updateCpuTime(frameStart, waited);
+		currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+
+		return true;
+	}
+
+	/**
+	 * Without a swap chain there is nothing to acquire or present, every frame in flight renders
+	 * into its own offscreen image. The pixels of a frame are handed to the frame callback when
+	 * its slot is reused, so the gpu renders the next frame while the previous one is consumed
+	 */
+	bool drawOffscreenFrame(const AudioData& audioData,
+	                        std::optional<std::chrono::milliseconds> time) {
+		const auto frameStart = std::chrono::steady_clock::now();
+		damaged = false;
+
+		vkWaitForFences(device.device, 1, &inFlightFences[currentFrame], VK_TRUE,
+		                std::numeric_limits<uint64_t>::max());
+		const auto waited = std::chrono::steady_clock::now() - frameStart;
+		finishReadback(currentFrame);
+		collectTimestamps(currentFrame);
+
+		updateAudioBuffers(audioData, currentFrame, time);
+
+		VkSubmitInfo submitInfo = {};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &commandBuffers[currentFrame][currentFrame];
+
+		vkResetFences(device.device, 1, &inFlightFences[currentFrame]);
+
+		if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]) !=
+		    VK_SUCCESS)
+			throw std::runtime_error(LOCATION "failed to submit draw command buffer!");
+		readbackPending[currentFrame] = static_cast<bool>(settings.frameCallback);
+		queriesPending[currentFrame] = settings.profile;
+
+		updateCpuTime(frameStart, waited);
 		currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 
 		return true;
 	}
 
+	void flush() {
+		// the slot about to be reused holds the oldest frame
+		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+			const size_t frame = (currentFrame + i) % MAX_FRAMES_IN_FLIGHT;
+			vkWaitForFences(device.device, 1, &inFlightFences[frame], VK_TRUE,
+			                std::numeric_limits<uint64_t>::max());
+			finishReadback(frame);
+		}
+	}
+
+	size_t bands() const { return settings.bands.value_or(0); }
+
+	bool gpuAnalysis() const { return analyseAudio; }
+
+	/**
+	 * Runs the analysis of the first frame slot on its own and reads the results back, the frames
+	 * in flight are waited on first as their slots are shared
+	 */
+	void analyse(AudioData& audioData) {
+		if (!analyseAudio) throw std::runtime_error(LOCATION "the gpu analysis is not used!");
+
+		vkDeviceWaitIdle(device.device);
+		updateAudioBuffers(audioData, 0, std::chrono::milliseconds(0));
+
+		VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+		if (stageAudio) recordAudioCopy(commandBuffer, 0);
+		recordAnalysis(commandBuffer, 0);
+
+		VkBufferMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = stageAudio ? VK_ACCESS_TRANSFER_READ_BIT : VK_ACCESS_HOST_READ_BIT;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer = shaderAudioBuffer().buffer;
+		barrier.offset = 0;
+		barrier.size = uploadSliceSize;
+
+		vkCmdPipelineBarrier(
+		    commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		    stageAudio ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_HOST_BIT, 0, 0,
+		    nullptr, 1, &barrier, 0, nullptr);
+
+		if (stageAudio) {
+			VkBufferCopy copyRegion = {};
+			copyRegion.size = uploadSliceSize;
+			vkCmdCopyBuffer(commandBuffer, deviceAudioBuffer.buffer, uploadBuffer.buffer, 1,
+			                &copyRegion);
+
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+			barrier.buffer = uploadBuffer.buffer;
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			                     VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &barrier, 0,
+			                     nullptr);
+		}
+		endSingleTimeCommands(commandBuffer);
+
+		UniformBufferObject ubo;
+		std::memcpy(&ubo, uploadData, sizeof(ubo));
+		audioData.lVolume = ubo.lVolume;
+		audioData.rVolume = ubo.rVolume;
+		std::copy_n(reinterpret_cast<const float*>(uploadData + lAudioOffset), settings.audioSize,
+		            audioData.lBuffer);
+		std::copy_n(reinterpret_cast<const float*>(uploadData + rAudioOffset), settings.audioSize,
+		            audioData.rBuffer);
+	}
+
+	void disableGpuAnalysis() {
+		if (!analyseAudio) return;
+
+		vkDeviceWaitIdle(device.device);
+		analyseAudio = false;
+
+		for (auto& frameCommandBuffers : commandBuffers)
+			vkFreeCommandBuffers(device.device, commandPool,
+			                     static_cast<uint32_t>(frameCommandBuffers.size()),
+			                     frameCommandBuffers.data());
+		createCommandBuffers();
+
+		queriesPending.fill(false);
+		if (settings.profile) updateQueryCount();
+		damaged = true;
+	}
+
+	bool needsRedraw(bool animate) const { return (animate && animated) || damaged; }
+
+	bool waitEvents(std::chrono::milliseconds timeout) {
+		if (settings.headless) {
+			std::unique_lock<std::mutex> lock(wakeMutex);
+			wakeCondition.wait_for(lock, timeout, [this]() { return woken; });
+			woken = false;
+			return true;
+		}
+
+		glfwWaitEventsTimeout(std::chrono::duration<double>(timeout).count());
+		return !glfwWindowShouldClose(window);
+	}
+
+	std::vector<GpuTime> gpuTimes() const {
+		std::vector<GpuTime> times;
+		if (!settings.profile) return times;
+
+		const auto summarise = [](std::string name, const RollingStatistics& statistics) {
+			return GpuTime{std::move(name), statistics.min(), statistics.average(),
+			               statistics.percentile(0.99f)};
+		};
+
+		if (!analysisTimes.empty()) times.push_back(summarise("analysis", analysisTimes));
+		if (!smoothingTimes.empty()) times.push_back(summarise("smoothing", smoothingTimes));
+
+		for (size_t module = 0; module < modules.size(); ++module) {
+			times.push_back(summarise(settings.modules[module].string(), moduleTimes[module]));
+			if (layerTimes[module].size() == 1) continue;
+
+			for (size_t layer = 0; layer < layerTimes[module].size(); ++layer)
+				times.push_back(summarise(settings.modules[module].string() + ':' +
+				                              std::to_string(layer + 1),
+				                          layerTimes[module][layer]));
+		}
+
+		return times;
+	}
+
+	float gpuFrameTime() const { return settings.profile ? frameTime : 0.f; }
+
+	float cpuFrameTime() const { return cpuTime; }
+
+	/**
+	 * Changes the render scale and smoothing level the modules not fixing their own are rendered
+	 * with, everything depending on them is recreated after the gpu has finished all frames
+	 */
+	void setQuality(float renderScale, float smoothingLevel) {
+		// modules whose sizes are in pixels fix their render scale, as scaling would resize them
+		const bool followsRenderScale =
+		    std::any_of(modules.begin(), modules.end(),
+		                [](const Module& module) { return !module.fixedRenderScale; });
+		if ((renderScale == settings.renderScale || !followsRenderScale) &&
+		    smoothingLevel == settings.smoothingLevel)
+			return;
+
+		vkDeviceWaitIdle(device.device);
+
+		for (auto& frameCommandBuffers : commandBuffers)
+			vkFreeCommandBuffers(device.device, commandPool,
+			                     static_cast<uint32_t>(frameCommandBuffers.size()),
+			                     frameCommandBuffers.data());
+
+		destroyGraphicsPipelines();
+		destroyScaledImages();
+		vkDestroyDescriptorPool(device.device, descriptorPool, nullptr);
+
+		settings.renderScale = renderScale;
+		settings.smoothingLevel = smoothingLevel;
+		applyRenderScale();
+		applySmoothing();
+
+		createUpscaleResources();
+		createGraphicsPipelines();
+		createScaledImages();
+		createDescriptorPool();
+		createDescriptorSets();
+		createCommandBuffers();
+
+		// the timestamps of frames recorded before the change are in a different order
+		queriesPending.fill(false);
+		if (settings.profile) updateQueryCount();
+		damaged = true;
+	}
+
+	void wake() {
+		if (settings.headless) {
+			{
+				std::lock_guard<std::mutex> lock(wakeMutex);
+				woken = true;
+			}
+			wakeCondition.notify_one();
+			return;
+		}
+
+		glfwPostEmptyEvent();
+	}
+
 	~RendererImpl() {
 		vkDeviceWaitIdle(device.device);
 
 		cleanupSwapChain();
+		destroyGraphicsPipelines();
 
 		for (size_t i = 0; i < modules.size(); ++i)
 			vkDestroyPipelineLayout(device.device, pipelineLayouts[i], nullptr);
 
 		vkDestroyRenderPass(device.device, renderPass, nullptr);
 
+		if (upscalePipelineLayout != VK_NULL_HANDLE) {
+			vkDestroyPipelineLayout(device.device, upscalePipelineLayout, nullptr);
+			vkDestroyDescriptorSetLayout(device.device, upscaleDescriptorSetLayout, nullptr);
+			vkDestroyRenderPass(device.device, scaledRenderPass, nullptr);
+			vkDestroyShaderModule(device.device, upscalePipeline.fragShaderModule, nullptr);
+			vkDestroyShaderModule(device.device, upscalePipeline.vertShaderModule, nullptr);
+		}
+
+		vkDestroyPipeline(device.device, smoothingPipeline, nullptr);
+		vkDestroyPipelineLayout(device.device, smoothingPipelineLayout, nullptr);
+		vkDestroyShaderModule(device.device, smoothingShaderModule, nullptr);
+
+		if (settings.gpuAnalysis) {
+			vkDestroyPipeline(device.device, analysisPipeline, nullptr);
+			vkDestroyPipelineLayout(device.device, analysisPipelineLayout, nullptr);
+			vkDestroyShaderModule(device.device, analysisShaderModule, nullptr);
+			vkDestroyDescriptorSetLayout(device.device, analysisDescriptorSetLayout, nullptr);
+		}
+
 		vkDestroyDescriptorPool(device.device, descriptorPool, nullptr);
 
 		vkDestroyDescriptorSetLayout(device.device, commonDescriptorSetLayout, nullptr);
+		vkDestroyDescriptorSetLayout(device.device, smoothingDescriptorSetLayout, nullptr);
 		for (auto& layout : descriptorSetLayouts)
 			vkDestroyDescriptorSetLayout(device.device, layout, nullptr);
 
-		for (size_t i = 0; i < dataBuffers.size(); ++i) {
-			Buffer::destroy(dataBuffers[i]);
-			Buffer::destroy(lAudioBuffers[i]);
-			Buffer::destroy(rAudioBuffers[i]);
+		uploadBuffer.unmapMemory();
+		Buffer::destroy(uploadBuffer);
+		if (settings.frameCallback) {
+			for (auto& buffer : readbackBuffers) {
+				buffer.unmapMemory();
+				Buffer::destroy(buffer);
+			}
 		}
+		if (stageAudio) Buffer::destroy(deviceAudioBuffer);
+		Buffer::destroy(smoothedBuffer);
+		if (settings.gpuAnalysis) Buffer::destroy(analysisBuffer);
+
+		for (auto& image : spectrumImages) Image::destroy(image);
+		vkDestroySampler(device.device, spectrumSampler, nullptr);
 
 		for (auto& module : modules) Module::destroy(device.device, module);
 
@@ -381,19 +763,27 @@ public:
 			vkDestroyFence(device.device, inFlightFences[i], nullptr);
 		}
 
+		if (settings.profile)
+			for (auto queryPool : queryPools) vkDestroyQueryPool(device.device, queryPool, nullptr);
+
 		vkDestroyCommandPool(device.device, commandPool, nullptr);
 
+		savePipelineCache();
+		vkDestroyPipelineCache(device.device, pipelineCache, nullptr);
+
 		vkDestroyDevice(device.device, nullptr);
 
 		if constexpr (enableValidationLayers)
 			DestroyDebugUtilsMessengerEXT(instance, debugMessenger, nullptr);
 
-		vkDestroySurfaceKHR(instance, surface, nullptr);
+		if (!settings.headless) vkDestroySurfaceKHR(instance, surface, nullptr);
 		vkDestroyInstance(instance, nullptr);
 
-		glfwDestroyWindow(window);
+		if (!settings.headless) {
+			glfwDestroyWindow(window);
 
-		glfwTerminate();
+			glfwTerminate();
+		}
 	}
 
 private:
@@ -402,6 +792,10 @@ private:
 	Settings settings;
 
 	GLFWwindow* window;
+	// set when the window contents need to be redrawn regardless of the audio
+	bool damaged = true;
+	// whether any of the modules depend on time
+	bool animated = false;
 
 	VkInstance instance;
 	VkDebugUtilsMessengerEXT debugMessenger;
@@ -414,6 +808,8 @@ private:
 	VkQueue presentQueue;
 
 	VkSwapchainKHR swapChain;
+	// images rendered to in place of the swap chain images when running headless
+	std::vector<Image> offscreenImages;
 	std::vector<VkImage> swapChainImages;
 	VkFormat swapChainImageFormat;
 	VkExtent2D swapChainExtent;
@@ -421,6 +817,7 @@ private:
 	std::vector<VkImageView> swapChainImageViews;
 	std::vector<VkFramebuffer> swapChainFramebuffers;
 
+	VkPipelineCache pipelineCache;
 	VkRenderPass renderPass;
 	VkDescriptorSetLayout commonDescriptorSetLayout;
 	std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
@@ -428,24 +825,111 @@ private:
 
 	std::vector<Module> modules;
 
-	VkCommandPool commandPool;
-	std::vector<VkCommandBuffer> commandBuffers;
+	// modules rendered at a reduced resolution are drawn in a render pass of their own before
+	// the window's, and are then upscaled into it by a fullscreen draw in between the others,
+	// the objects needed for this are only created once a module is scaled
+	size_t scaledModuleCount = 0;
+	VkRenderPass scaledRenderPass;
+	VkDescriptorSetLayout upscaleDescriptorSetLayout;
+	VkPipelineLayout upscalePipelineLayout = VK_NULL_HANDLE;
+	GraphicsPipeline upscalePipeline;
+
+	// the spectrum is smoothed once per frame by a compute pass for each distinct kernel and level
+	// of the modules, each channel into its own part of the smoothed buffer
+	struct SmoothingPass {
+		SmoothingKernel kernel;
+		float level;
+	};
+	std::vector<SmoothingPass> smoothingPasses;
+	VkDescriptorSetLayout smoothingDescriptorSetLayout;
+	VkPipelineLayout smoothingPipelineLayout;
+	VkShaderModule smoothingShaderModule;
+	VkPipeline smoothingPipeline;
+	// smoothed spectra of each frame in flight, with room for a pass per module
+	Buffer smoothedBuffer;
+	VkDeviceSize smoothedStride;
+	RollingStatistics smoothingTimes;
+
+	// the spectra may also be published as 1D images of each frame in flight, spectra and channel,
+	// copied from the buffers every frame for the modules that read them
+	bool useSpectrumImages = false;
+	bool filterSpectrumImages = false;
+	std::vector<Image> spectrumImages;
+	VkSampler spectrumSampler = VK_NULL_HANDLE;
+
+	// the spectra and volumes may be computed from the samples of each frame by a chain of
+	// compute dispatches, which write them to the frame's slice where the cpu would have put them
+	bool analyseAudio = false;
+	VkDescriptorSetLayout analysisDescriptorSetLayout;
+	VkPipelineLayout analysisPipelineLayout;
+	VkShaderModule analysisShaderModule;
+	VkPipeline analysisPipeline;
+	// the intermediate results of the fft and the magnitudes of each frame in flight
+	Buffer analysisBuffer;
+	VkDeviceSize analysisStride;
+	RollingStatistics analysisTimes;
 
-	std::vector<Buffer> dataBuffers;
-	std::vector<Buffer> lAudioBuffers;
-	std::vector<Buffer> rAudioBuffers;
+	VkCommandPool commandPool;
+	// command buffers for each frame in flight and swap chain image
+	std::array<std::vector<VkCommandBuffer>, MAX_FRAMES_IN_FLIGHT> commandBuffers;
+
+	// persistently mapped buffer holding the uniform buffer objects and the audio of each frame
+	// in flight in consecutive slices, every module has its own uniform buffer object as the
+	// size it is rendered at may differ
+	Buffer uploadBuffer;
+	char* uploadData;
+	VkDeviceSize uploadSliceSize;
+	VkDeviceSize uniformStride;
+	VkDeviceSize lAudioOffset;
+	VkDeviceSize rAudioOffset;
+	// the samples of the frame, only uploaded for the gpu analysis
+	VkDeviceSize samplesOffset;
+	// device local copy of the upload buffer which the shaders read from when the gpu has its
+	// own memory, every frame copies its slice over before rendering
+	bool stageAudio;
+	Buffer deviceAudioBuffer;
+
+	// host visible copies of the offscreen image of each frame in flight, only used when there is
+	// a frame callback
+	std::array<Buffer, MAX_FRAMES_IN_FLIGHT> readbackBuffers;
+	std::array<unsigned char*, MAX_FRAMES_IN_FLIGHT> readbackData;
+	std::array<bool, MAX_FRAMES_IN_FLIGHT> readbackPending = {};
 
 	Image backgroundImage;
 
 	VkDescriptorPool descriptorPool;
-	std::vector<VkDescriptorSet> commonDescriptorSets;
-	std::vector<std::vector<VkDescriptorSet>> descriptorSets;
+	// common descriptor sets of each frame in flight and spectra
+	std::array<std::vector<VkDescriptorSet>, MAX_FRAMES_IN_FLIGHT> commonDescriptorSets;
+	std::vector<VkDescriptorSet> descriptorSets;
+	// descriptor sets of each frame in flight, smoothing pass and channel
+	std::array<std::vector<VkDescriptorSet>, MAX_FRAMES_IN_FLIGHT> smoothingDescriptorSets;
+	std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> analysisDescriptorSets;
+
+	// timestamps written before the first layer and after every layer, one pool per frame in
+	// flight so that the results of a frame are only read once its fence has been waited on
+	std::array<VkQueryPool, MAX_FRAMES_IN_FLIGHT> queryPools;
+	std::array<bool, MAX_FRAMES_IN_FLIGHT> queriesPending = {};
+	uint32_t queryCount;
+	// milliseconds between the first and last timestamp of the latest frame collected
+	float frameTime = 0.f;
+	// milliseconds the latest frame drawn spent on the cpu, without waiting for the gpu and the
+	// swap chain
+	float cpuTime = 0.f;
+	float timestampPeriod;
+	uint64_t timestampMask;
+	std::vector<RollingStatistics> moduleTimes;
+	std::vector<std::vector<RollingStatistics>> layerTimes;
 
 	std::array<VkSemaphore, MAX_FRAMES_IN_FLIGHT> imageAvailableSemaphores;
 	std::array<VkSemaphore, MAX_FRAMES_IN_FLIGHT> renderFinishedSemaphores;
 	std::array<VkFence, MAX_FRAMES_IN_FLIGHT> inFlightFences;
 	size_t currentFrame = 0;
 
+	// lets wake() interrupt waitEvents() when there is no window to post an event to
+	std::mutex wakeMutex;
+	std::condition_variable wakeCondition;
+	bool woken = false;
+
 	// Member functions
 
 	void initWindow() {
@@ -483,30 +967,63 @@ private:
 		if (settings.window.position)
 			glfwSetWindowPos(window, settings.window.position->first,
 			                 settings.window.position->second);
+
+		glfwSetWindowUserPointer(window, this);
+		glfwSetWindowRefreshCallback(window, [](GLFWwindow* window) {
+			reinterpret_cast<RendererImpl*>(glfwGetWindowUserPointer(window))->damaged = true;
+		});
 	}
 
 	void initVulkan() {
+		auto phaseStart = std::chrono::steady_clock::now();
+		const auto endPhase = [&phaseStart](const char* phase) {
+			const auto phaseEnd = std::chrono::steady_clock::now();
+			std::clog << "    " << phase << " took: "
+			          << std::chrono::duration_cast<std::chrono::milliseconds>(phaseEnd -
+			                                                                    phaseStart)
+			                 .count()
+			          << " milliseconds" << std::endl;
+			phaseStart = phaseEnd;
+		};
+
 		createInstance();
 		setupDebugCallback();
-		createSurface();
+		if (!settings.headless) createSurface();
 		pickPhysicalDevice();
 		createLogicalDevice();
-		createSwapchain();
+		createPipelineCache();
+		endPhase("Device creation");
+		if (settings.headless)
+			createOffscreenImages();
+		else
+			createSwapchain();
 		createImageViews();
 		createRenderPass();
+		endPhase("Swapchain creation");
 		discoverModules();
+		endPhase("Module loading");
 		createDescriptorSetLayouts();
 		createGraphicsPipelineLayouts();
+		createUpscaleResources();
 		createGraphicsPipelines();
+		createSmoothingPipeline();
+		if (settings.gpuAnalysis) createAnalysisPipeline();
+		endPhase("Pipeline creation");
 		createFramebuffers();
+		createScaledImages();
 		createCommandPool();
+		if (settings.profile) createQueryPools();
 		createAudioBuffers();
+		if (useSpectrumImages) createSpectrumImages();
+		if (settings.frameCallback) createReadbackBuffers();
 		createModuleImages();
 		createBackgroundImage();
 		createDescriptorPool();
 		createDescriptorSets();
+		endPhase("Resource creation");
 		createCommandBuffers();
 		createSyncObjects();
+		endPhase("Command recording");
 	}
 
 	void createInstance() {
@@ -539,6 +1056,13 @@ private:
 	}
 
 	std::vector<const char*> getRequiredExtensions() const {
+		if (settings.headless) {
+			if constexpr (enableValidationLayers)
+				return {VK_EXT_DEBUG_UTILS_EXTENSION_NAME};
+			else
+				return {};
+		}
+
 		uint32_t glfwExtensionCount = 0;
 		const char** glfwExtensions;
 		glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
@@ -644,8 +1168,8 @@ private:
 
 		bool extensionsSupported = checkDeviceExtensionSupport(device);
 
-		bool swapChainAdequate = false;
-		if (extensionsSupported) {
+		bool swapChainAdequate = settings.headless;
+		if (extensionsSupported && !settings.headless) {
 			SwapChainSupportDetails swapChainDetails = querySwapChainSupport(device);
 			swapChainAdequate =
 			    !swapChainDetails.formats.empty() && !swapChainDetails.presentModes.empty();
@@ -662,6 +1186,13 @@ private:
 		       uniformBufferSizeAdequate;
 	}
 
+	std::vector<const char*> getRequiredDeviceExtensions() const {
+		if (settings.headless)
+			return {};
+		else
+			return deviceExtensions;
+	}
+
 	bool checkDeviceExtensionSupport(VkPhysicalDevice device) const {
 		uint32_t availableExtensionCount = 0;
 		vkEnumerateDeviceExtensionProperties(device, nullptr, &availableExtensionCount, nullptr);
@@ -669,7 +1200,8 @@ private:
 		vkEnumerateDeviceExtensionProperties(device, nullptr, &availableExtensionCount,
 		                                     availableExtensions.data());
 
-		std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
+		const auto extensions = getRequiredDeviceExtensions();
+		std::set<std::string> requiredExtensions(extensions.begin(), extensions.end());
 		for (const auto& availableExtension : availableExtensions)
 			requiredExtensions.erase(availableExtension.extensionName);
 
@@ -689,11 +1221,16 @@ private:
 			if (queueFamily.queueCount <= 0) continue;
 
 			VkBool32 presentSupport = false;
-			vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+			if (!settings.headless)
+				vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
 
 			if (presentSupport) indices.presentFamily = i;
 
-			if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) indices.graphicsFamily = i;
+			if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+				indices.graphicsFamily = i;
+				// nothing is presented without a window, so the graphics queue is used for both
+				if (settings.headless) indices.presentFamily = i;
+			}
 
 			if (indices.isComplete()) break;
 
@@ -722,6 +1259,7 @@ private:
 
 		VkPhysicalDeviceFeatures deviceFeatures = {};
 
+		const auto extensions = getRequiredDeviceExtensions();
 		const auto layers = getRequiredLayers();
 
 		VkDeviceCreateInfo deviceInfo = {};
@@ -729,8 +1267,8 @@ private:
 		deviceInfo.pQueueCreateInfos = queueInfos.data();
 		deviceInfo.queueCreateInfoCount = static_cast<uint32_t>(queueInfos.size());
 		deviceInfo.pEnabledFeatures = &deviceFeatures;
-		deviceInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-		deviceInfo.ppEnabledExtensionNames = deviceExtensions.data();
+		deviceInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+		deviceInfo.ppEnabledExtensionNames = extensions.data();
 		deviceInfo.enabledLayerCount = static_cast<uint32_t>(layers.size());
 		deviceInfo.ppEnabledLayerNames = layers.data();
 
@@ -824,6 +1362,26 @@ private:
 		swapChainExtent = extent;
 	}
 
+	/**
+	 * Creates the images rendered to when running headless, they take the place of the swap
+	 * chain images so that the rest of the renderer does not need to know about them
+	 */
+	void createOffscreenImages() {
+		swapChainImageFormat = VK_FORMAT_R8G8B8A8_UNORM;
+		swapChainExtent = {settings.window.width, settings.window.height};
+
+		offscreenImages.resize(MAX_FRAMES_IN_FLIGHT);
+		swapChainImages.resize(offscreenImages.size());
+		for (size_t i = 0; i < offscreenImages.size(); ++i) {
+			offscreenImages[i] =
+			    Image(device, swapChainExtent.width, swapChainExtent.height, VK_IMAGE_TYPE_2D,
+			          swapChainImageFormat, VK_IMAGE_TILING_OPTIMAL,
+			          VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+			          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+			swapChainImages[i] = offscreenImages[i].image;
+		}
+	}
+
 	SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device) const {
 		SwapChainSupportDetails details;
 		vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, surface, &details.capabilities);
@@ -904,43 +1462,187 @@ private:
 			swapChainImageViews[i] = createImageView(swapChainImages[i], swapChainImageFormat);
 	}
 
+	/**
+	 * Loads every module on its own thread, as reading and creating the shaders of a module is
+	 * independent of the other modules
+	 */
 	void discoverModules() {
 		modules.resize(settings.modules.size());
 
-		for (uint32_t i = 0; i < modules.size(); ++i) {
-			modules[i].location = findModule(settings.modules[i]);
-
-			// find number of layers
-			uint32_t layerCount = 1;
-			while (std::filesystem::exists(modules[i].location / std::to_string(layerCount + 1)))
-				++layerCount;
-			modules[i].layers.resize(layerCount);
-
-			// find fallback vertex shader
-			const auto fallbackVertShaderPath =
-			    std::filesystem::exists(modules[i].location / "vert.spv")
-			        ? modules[i].location
-			        : settings.moduleLocations.front() / "modules";
-
-			// find and create shaders for each layer
-			for (uint32_t layer = 0; layer < layerCount; ++layer) {
-				auto vertexShaderPath = modules[i].location / std::to_string(layer + 1);
-				if (!std::filesystem::exists(vertexShaderPath / "vert.spv"))
-					vertexShaderPath = fallbackVertShaderPath;
-
-				auto vertShaderCode = readFile(vertexShaderPath / "vert.spv");
-				modules[i].layers[layer].vertShaderModule = createShaderModule(vertShaderCode);
-
-				auto fragmentShaderPath = modules[i].location / std::to_string(layer + 1);
-				auto fragShaderCode = readFile(fragmentShaderPath / "frag.spv");
-				modules[i].layers[layer].fragShaderModule = createShaderModule(fragShaderCode);
+		std::vector<std::future<bool>> loaded;
+		loaded.reserve(modules.size());
+		for (uint32_t i = 0; i < modules.size(); ++i)
+			loaded.push_back(std::async(std::launch::async, &RendererImpl::loadModule, this,
+			                            std::ref(modules[i]), std::cref(settings.modules[i])));
+
+		// get() rethrows any exception thrown while loading
+		for (auto& moduleAnimated : loaded)
+			if (moduleAnimated.get()) animated = true;
+
+		chooseBands();
+		chooseAnalysis();
+
+		for (auto& module : modules) {
+			module.specializationConstants.data[0] = static_cast<uint32_t>(settings.audioSize);
+			module.specializationConstants.data[4] = module.vertexCount;
+
+			const auto& renderScale = module.fixedRenderScale;
+			if (renderScale && !(renderScale.value() > 0.f && renderScale.value() <= 1.f)) {
+				std::cerr << LOCATION "renderScale of module " << module.location
+				          << " set to an invalid value!\n";
+				module.fixedRenderScale = 1.f;
+			}
+			if (module.instanceSize && !(module.instanceSize.value() > 0.f)) {
+				std::cerr << LOCATION "instanceSize of module " << module.location
+				          << " set to an invalid value!\n";
+				module.instanceSize.reset();
+			}
+			if (module.fixedSmoothingLevel && module.fixedSmoothingLevel.value() < 0.f) {
+				std::cerr << LOCATION "smoothingLevel of module " << module.location
+				          << " set to an invalid value!\n";
+				module.fixedSmoothingLevel.reset();
+			}
+		}
+
+		useSpectrumImages = std::any_of(modules.begin(), modules.end(),
+		                                [](const Module& module) { return module.spectrumImages; });
+		if (useSpectrumImages) filterSpectrumImages = spectrumImagesFilterable();
+		for (auto& module : modules)
+			module.specializationConstants.data[5] =
+			    static_cast<uint32_t>(module.spectrumImages && filterSpectrumImages);
+
+		applyRenderScale();
+		applySmoothing();
+	}
+
+	/**
+	 * Assigns every module the spectra smoothed with its kernel and level, modules sharing both
+	 * share a smoothing pass. Modules smoothing in their shaders get the level as specialization
+	 * constant 1 and read the unsmoothed spectra, the others get 0
+	 */
+	void applySmoothing() {
+		smoothingPasses.clear();
+		for (auto& module : modules) {
+			const float level = module.fixedSmoothingLevel.value_or(settings.smoothingLevel);
+			const bool shaderSmoothing = module.smoothingKernel == SmoothingKernel::shader;
+			module.specializationConstants.data[1] = shaderSmoothing ? level : 0.f;
+
+			module.spectra = 0;
+			if (shaderSmoothing || level == 0.f) continue;
+
+			const auto pass = std::find_if(
+			    smoothingPasses.begin(), smoothingPasses.end(), [&](const SmoothingPass& pass) {
+				    return pass.kernel == module.smoothingKernel && pass.level == level;
+			    });
+			module.spectra = pass - smoothingPasses.begin() + 1;
+			if (pass == smoothingPasses.end())
+				smoothingPasses.push_back({module.smoothingKernel, level});
+		}
+	}
+
+	/**
+	 * Sets the render scale of the modules not fixing their own to the global one
+	 */
+	void applyRenderScale() {
+		scaledModuleCount = 0;
+		for (auto& module : modules) {
+			module.renderScale = module.fixedRenderScale.value_or(settings.renderScale);
+			if (module.scaled()) ++scaledModuleCount;
+		}
+	}
+
+	/**
+	 * Finds the module and creates the shaders of each of its layers, returns whether any of
+	 * them depend on time
+	 */
+	bool loadModule(Module& module, const std::filesystem::path& name) const {
+		bool moduleAnimated = false;
+		module.location = findModule(name);
+
+		// find number of layers
+		uint32_t layerCount = 1;
+		while (std::filesystem::exists(module.location / std::to_string(layerCount + 1)))
+			++layerCount;
+		module.layers.resize(layerCount);
+
+		// find fallback vertex shader
+		const auto fallbackVertShaderPath = std::filesystem::exists(module.location / "vert.spv")
+		                                        ? module.location
+		                                        : settings.moduleLocations.front() / "modules";
+
+		// find and create shaders for each layer
+		for (uint32_t layer = 0; layer < layerCount; ++layer) {
+			auto vertexShaderPath = module.location / std::to_string(layer + 1);
+			if (!std::filesystem::exists(vertexShaderPath / "vert.spv"))
+				vertexShaderPath = fallbackVertShaderPath;
+
+			auto vertShaderCode = readFile(vertexShaderPath / "vert.spv");
+			module.layers[layer].vertShaderModule = createShaderModule(vertShaderCode);
+
+			auto fragmentShaderPath = module.location / std::to_string(layer + 1);
+			auto fragShaderCode = readFile(fragmentShaderPath / "frag.spv");
+			module.layers[layer].fragShaderModule = createShaderModule(fragShaderCode);
+
+			// time is the third member of the uniform block, shaders may declare it only to
+			// reach the window size after it
+			if (uniformBlockMemberUsed(vertShaderCode, 0, 0, 2) ||
+			    uniformBlockMemberUsed(fragShaderCode, 0, 0, 2))
+				moduleAnimated = true;
+
+			for (uint32_t id : {2, 3})
+				if (hasSpecializationConstant(vertShaderCode, id) ||
+				    hasSpecializationConstant(fragShaderCode, id))
+					module.extentDependent = true;
+		}
+
+		readConfig(module.location / "config", module);
+		return moduleAnimated;
+	}
+
+	/**
+	 * The spectrum is only reduced to bands when every module asks for them, as the audio
+	 * buffers are shared between modules
+	 */
+	void chooseBands() {
+		if (!settings.bands) {
+			size_t moduleBands = 0;
+			for (auto& module : modules) {
+				if (!module.bands) {
+					moduleBands = 0;
+					break;
+				}
+				moduleBands = std::max<size_t>(moduleBands, module.bands.value());
 			}
+			settings.bands = moduleBands;
+		}
+
+		if (settings.bands.value() >= settings.audioSize) settings.bands = 0;
+		if (settings.bands.value()) {
+			settings.audioSize = settings.bands.value();
+			std::clog << "Reducing audio to " << settings.audioSize << " bands" << std::endl;
+		}
+	}
 
-			readConfig(modules[i].location / "config", modules[i]);
-			modules[i].specializationConstants.data[0] = static_cast<uint32_t>(settings.audioSize);
-			modules[i].specializationConstants.data[1] = settings.smoothingLevel;
-			modules[i].specializationConstants.data[4] = modules[i].vertexCount;
+	/**
+	 * The gpu analysis computes the full spectrum, it is not used when the spectrum is reduced
+	 * to bands
+	 */
+	void chooseAnalysis() {
+		if (!settings.gpuAnalysis) return;
+
+		const size_t size = settings.gpuAnalysis->size;
+		if (size < 2 || (size & (size - 1))) {
+			std::cerr << LOCATION "the gpu analysis requires a buffer size that is a power of 2, "
+			                      "analysing audio on the cpu!\n";
+			settings.gpuAnalysis.reset();
+		} else if (settings.bands.value()) {
+			std::cerr << LOCATION "the gpu analysis does not reduce the spectrum to bands, "
+			                      "analysing audio on the cpu!\n";
+			settings.gpuAnalysis.reset();
 		}
+
+		analyseAudio = settings.gpuAnalysis.has_value();
+		if (analyseAudio) std::clog << "Analysing audio on the gpu" << std::endl;
 	}
 
 	std::filesystem::path findModule(const std::string& moduleName) const {
@@ -972,7 +1674,11 @@ private:
 		}
 	}
 
-	void createGraphicsPipelines() {
+	/**
+	 * Creates the pipelines of every module, or only of those depending on the window size, along
+	 * with the upscale pipeline, which always depends on it
+	 */
+	void createGraphicsPipelines(bool extentDependentOnly = false) {
 		VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
 		vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
 		vertexInputInfo.vertexBindingDescriptionCount = 0;
@@ -983,24 +1689,21 @@ private:
 		inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
 		inputAssembly.primitiveRestartEnable = VK_FALSE;
 
-		VkViewport viewport = {};
-		viewport.x = 0.0f;
-		viewport.y = 0.0f;
-		viewport.width = static_cast<float>(swapChainExtent.width);
-		viewport.height = static_cast<float>(swapChainExtent.height);
-		viewport.minDepth = 0.0f;
-		viewport.maxDepth = 1.0f;
-
-		VkRect2D scissor = {};
-		scissor.offset = {0, 0};
-		scissor.extent = swapChainExtent;
-
+		// set while recording so that resizing does not invalidate the pipelines
 		VkPipelineViewportStateCreateInfo viewportState = {};
 		viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
 		viewportState.viewportCount = 1;
-		viewportState.pViewports = &viewport;
+		viewportState.pViewports = nullptr;
 		viewportState.scissorCount = 1;
-		viewportState.pScissors = &scissor;
+		viewportState.pScissors = nullptr;
+
+		std::array<VkDynamicState, 2> dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT,
+		                                               VK_DYNAMIC_STATE_SCISSOR};
+
+		VkPipelineDynamicStateCreateInfo dynamicState = {};
+		dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+		dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+		dynamicState.pDynamicStates = dynamicStates.data();
 
 		VkPipelineRasterizationStateCreateInfo rasterizer = {};
 		rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
@@ -1034,17 +1737,41 @@ private:
 		colorBlending.attachmentCount = 1;
 		colorBlending.pAttachments = &colorBlendAttachment;
 
+		// the alpha of a scaled image is the coverage of all of the module's layers together, as
+		// it is used to blend them over the modules below when upscaling
+		VkPipelineColorBlendAttachmentState scaledBlendAttachment = colorBlendAttachment;
+		scaledBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+
+		VkPipelineColorBlendStateCreateInfo scaledBlending = colorBlending;
+		scaledBlending.pAttachments = &scaledBlendAttachment;
+
+		// scaled modules are blended over a transparent image, so the colors being upscaled are
+		// already multiplied by their alpha
+		VkPipelineColorBlendAttachmentState upscaleBlendAttachment = colorBlendAttachment;
+		upscaleBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+		upscaleBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+
+		VkPipelineColorBlendStateCreateInfo upscaleBlending = colorBlending;
+		upscaleBlending.pAttachments = &upscaleBlendAttachment;
+
+		std::vector<uint32_t> moduleIndices;
 		size_t pipelineCount = 0;
-		for (const auto& module : modules) pipelineCount += module.layers.size();
+		for (uint32_t module = 0; module < modules.size(); ++module) {
+			if (extentDependentOnly && !modules[module].extentDependent) continue;
+			moduleIndices.push_back(module);
+			pipelineCount += modules[module].layers.size();
+		}
+		if (scaledModuleCount) ++pipelineCount;
+		if (pipelineCount == 0) return;
 
 		std::vector<VkSpecializationInfo> specializationInfos;
-		specializationInfos.reserve(modules.size());
+		specializationInfos.reserve(moduleIndices.size());
 		std::vector<std::array<VkPipelineShaderStageCreateInfo, 2>> shaderStages;
 		shaderStages.reserve(pipelineCount);
 		std::vector<VkGraphicsPipelineCreateInfo> pipelineInfos;
 		pipelineInfos.reserve(pipelineCount);
 
-		for (uint32_t module = 0; module < modules.size(); ++module) {
+		for (uint32_t module : moduleIndices) {
 			VkSpecializationInfo specializationInfo = {};
 			specializationInfo.mapEntryCount =
 			    modules[module].specializationConstants.specializationInfo.size();
@@ -1056,8 +1783,9 @@ private:
 			specializationInfos.push_back(specializationInfo);
 
 			for (uint32_t layer = 0; layer < modules[module].layers.size(); ++layer) {
-				modules[module].specializationConstants.data[2] = swapChainExtent.width;
-				modules[module].specializationConstants.data[3] = swapChainExtent.height;
+				const VkExtent2D extent = moduleExtent(modules[module]);
+				modules[module].specializationConstants.data[2] = extent.width;
+				modules[module].specializationConstants.data[3] = extent.height;
 
 				VkPipelineShaderStageCreateInfo vertShaderStageInfo = {};
 				vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -1071,7 +1799,7 @@ private:
 				fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
 				fragShaderStageInfo.module = modules[module].layers[layer].fragShaderModule;
 				fragShaderStageInfo.pName = modules[module].moduleName.c_str();
-				fragShaderStageInfo.pSpecializationInfo = &specializationInfos[module];
+				fragShaderStageInfo.pSpecializationInfo = &specializationInfos.back();
 
 				shaderStages.push_back({vertShaderStageInfo, fragShaderStageInfo});
 
@@ -1085,8 +1813,9 @@ private:
 				pipelineInfo.pRasterizationState = &rasterizer;
 				pipelineInfo.pMultisampleState = &multisampling;
 				pipelineInfo.pDepthStencilState = nullptr;
-				pipelineInfo.pColorBlendState = &colorBlending;
-				pipelineInfo.pDynamicState = nullptr;
+				pipelineInfo.pColorBlendState =
+				    modules[module].scaled() ? &scaledBlending : &colorBlending;
+				pipelineInfo.pDynamicState = &dynamicState;
 				pipelineInfo.layout = pipelineLayouts[module];
 				pipelineInfo.renderPass = renderPass;
 				pipelineInfo.subpass = 0;
@@ -1097,17 +1826,263 @@ private:
 			}
 		}
 
+		// the upscale shaders only use the window size
+		const std::array<uint32_t, 2> upscaleConstants = {swapChainExtent.width,
+		                                                  swapChainExtent.height};
+		std::array<VkSpecializationMapEntry, 2> upscaleMapEntries = {};
+		for (uint32_t i = 0; i < upscaleMapEntries.size(); ++i) {
+			upscaleMapEntries[i].constantID = 2 + i;
+			upscaleMapEntries[i].offset = i * sizeof(uint32_t);
+			upscaleMapEntries[i].size = sizeof(uint32_t);
+		}
+
+		VkSpecializationInfo upscaleSpecializationInfo = {};
+		upscaleSpecializationInfo.mapEntryCount = upscaleMapEntries.size();
+		upscaleSpecializationInfo.pMapEntries = upscaleMapEntries.data();
+		upscaleSpecializationInfo.dataSize = sizeof(upscaleConstants);
+		upscaleSpecializationInfo.pData = upscaleConstants.data();
+
+		if (scaledModuleCount) {
+			VkPipelineShaderStageCreateInfo vertShaderStageInfo = {};
+			vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+			vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+			vertShaderStageInfo.module = upscalePipeline.vertShaderModule;
+			vertShaderStageInfo.pName = "main";
+
+			VkPipelineShaderStageCreateInfo fragShaderStageInfo = {};
+			fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+			fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+			fragShaderStageInfo.module = upscalePipeline.fragShaderModule;
+			fragShaderStageInfo.pName = "main";
+			fragShaderStageInfo.pSpecializationInfo = &upscaleSpecializationInfo;
+
+			shaderStages.push_back({vertShaderStageInfo, fragShaderStageInfo});
+
+			VkGraphicsPipelineCreateInfo pipelineInfo = {};
+			pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+			pipelineInfo.stageCount = 2;
+			pipelineInfo.pStages = shaderStages.back().data();
+			pipelineInfo.pVertexInputState = &vertexInputInfo;
+			pipelineInfo.pInputAssemblyState = &inputAssembly;
+			pipelineInfo.pViewportState = &viewportState;
+			pipelineInfo.pRasterizationState = &rasterizer;
+			pipelineInfo.pMultisampleState = &multisampling;
+			pipelineInfo.pDepthStencilState = nullptr;
+			pipelineInfo.pColorBlendState = &upscaleBlending;
+			pipelineInfo.pDynamicState = &dynamicState;
+			pipelineInfo.layout = upscalePipelineLayout;
+			pipelineInfo.renderPass = renderPass;
+			pipelineInfo.subpass = 0;
+			pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+			pipelineInfo.basePipelineIndex = 0;
+
+			pipelineInfos.push_back(pipelineInfo);
+		}
+
+		// drivers compile the pipelines of separate calls in parallel, so each module gets its
+		// own thread, the pipeline cache is internally synchronised
 		std::vector<VkPipeline> pipelines(pipelineCount);
-		if (vkCreateGraphicsPipelines(device.device, VK_NULL_HANDLE, pipelines.size(),
-		                              pipelineInfos.data(), nullptr, pipelines.data()))
+		std::vector<std::future<VkResult>> results;
+		results.reserve(moduleIndices.size());
+		size_t first = 0;
+		for (uint32_t module : moduleIndices) {
+			const uint32_t layerCount = modules[module].layers.size();
+			results.push_back(std::async(std::launch::async, [&, first, layerCount]() {
+				return vkCreateGraphicsPipelines(device.device, pipelineCache, layerCount,
+				                                 &pipelineInfos[first], nullptr,
+				                                 &pipelines[first]);
+			}));
+			first += layerCount;
+		}
+		if (scaledModuleCount)
+			results.push_back(std::async(std::launch::async, [&, first]() {
+				return vkCreateGraphicsPipelines(device.device, pipelineCache, 1,
+				                                 &pipelineInfos[first], nullptr,
+				                                 &pipelines[first]);
+			}));
+
+		bool failed = false;
+		for (auto& result : results)
+			if (result.get() != VK_SUCCESS) failed = true;
+		if (failed) {
+			// the pipelines that failed are null, the others would leak
+			for (VkPipeline pipeline : pipelines)
+				vkDestroyPipeline(device.device, pipeline, nullptr);
 			throw std::runtime_error(LOCATION "failed to create graphics pipeline!");
+		}
 
 		uint32_t i = 0;
-		for (auto& module : modules)
-			for (auto& layer : module.layers) layer.graphicsPipeline = pipelines[i++];
+		for (uint32_t module : moduleIndices)
+			for (auto& layer : modules[module].layers) layer.graphicsPipeline = pipelines[i++];
+		if (scaledModuleCount) upscalePipeline.graphicsPipeline = pipelines[i];
+	}
+
+	void destroyGraphicsPipelines(bool extentDependentOnly = false) {
+		for (auto& module : modules) {
+			if (extentDependentOnly && !module.extentDependent) continue;
+			for (auto& layer : module.layers) {
+				vkDestroyPipeline(device.device, layer.graphicsPipeline, nullptr);
+				layer.graphicsPipeline = VK_NULL_HANDLE;
+			}
+		}
+
+		if (scaledModuleCount) {
+			vkDestroyPipeline(device.device, upscalePipeline.graphicsPipeline, nullptr);
+			upscalePipeline.graphicsPipeline = VK_NULL_HANDLE;
+		}
+	}
+
+	void createSmoothingPipeline() {
+		VkPushConstantRange pushConstantRange = {};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(SmoothingPushConstants);
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &smoothingDescriptorSetLayout;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+		if (vkCreatePipelineLayout(device.device, &pipelineLayoutInfo, nullptr,
+		                           &smoothingPipelineLayout) != VK_SUCCESS)
+			throw std::runtime_error(LOCATION "failed to create pipeline layout!");
+
+		smoothingShaderModule = createShaderModule(readFile(
+		    settings.moduleLocations.front() / "modules" / "smoothing" / "comp.spv"));
+
+		VkComputePipelineCreateInfo pipelineInfo = {};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = smoothingShaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = smoothingPipelineLayout;
+
+		if (vkCreateComputePipelines(device.device, pipelineCache, 1, &pipelineInfo, nullptr,
+		                             &smoothingPipeline) != VK_SUCCESS)
+			throw std::runtime_error(LOCATION "failed to create compute pipeline!");
+	}
+
+	void createAnalysisPipeline() {
+		VkPushConstantRange pushConstantRange = {};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(AnalysisPushConstants);
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &analysisDescriptorSetLayout;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+		if (vkCreatePipelineLayout(device.device, &pipelineLayoutInfo, nullptr,
+		                           &analysisPipelineLayout) != VK_SUCCESS)
+			throw std::runtime_error(LOCATION "failed to create pipeline layout!");
+
+		analysisShaderModule = createShaderModule(readFile(
+		    settings.moduleLocations.front() / "modules" / "analysis" / "comp.spv"));
+
+		VkComputePipelineCreateInfo pipelineInfo = {};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = analysisShaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = analysisPipelineLayout;
+
+		if (vkCreateComputePipelines(device.device, pipelineCache, 1, &pipelineInfo, nullptr,
+		                             &analysisPipeline) != VK_SUCCESS)
+			throw std::runtime_error(LOCATION "failed to create compute pipeline!");
+	}
+
+	/**
+	 * Creates the pipeline cache from the data saved by the last run, if it was created by the
+	 * same device and driver
+	 */
+	void createPipelineCache() {
+		std::vector<char> cacheData;
+
+		if (!settings.pipelineCachePath.empty() &&
+		    std::filesystem::exists(settings.pipelineCachePath)) {
+			VkPhysicalDeviceProperties deviceProperties;
+			vkGetPhysicalDeviceProperties(device.physicalDevice, &deviceProperties);
+
+			std::error_code error;
+			const uintmax_t fileSize =
+			    std::filesystem::file_size(settings.pipelineCachePath, error);
+
+			std::ifstream file(settings.pipelineCachePath, std::ios::binary);
+			PipelineCacheHeader header;
+			file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+			// the size in the header is only trusted if it accounts for exactly the rest of the
+			// file, anything else is a damaged cache
+			if (error || !file || fileSize - sizeof(header) != header.dataSize) {
+				std::clog << "Discarding damaged pipeline cache" << std::endl;
+			} else if (!header.matches(PipelineCacheHeader(deviceProperties, 0))) {
+				std::clog << "Discarding pipeline cache created by a different device or driver"
+				          << std::endl;
+			} else {
+				cacheData.resize(header.dataSize);
+				file.read(cacheData.data(), cacheData.size());
+				if (!file) {
+					cacheData.clear();
+					std::clog << "Discarding pipeline cache that couldn't be read" << std::endl;
+				}
+			}
+		}
+
+		VkPipelineCacheCreateInfo cacheInfo = {};
+		cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		cacheInfo.initialDataSize = cacheData.size();
+		cacheInfo.pInitialData = cacheData.data();
+
+		if (vkCreatePipelineCache(device.device, &cacheInfo, nullptr, &pipelineCache) !=
+		    VK_SUCCESS)
+			throw std::runtime_error(LOCATION "failed to create pipeline cache!");
+	}
+
+	/**
+	 * Writes the pipeline cache to disk, failures are reported but not fatal as the cache can
+	 * always be rebuilt
+	 */
+	void savePipelineCache() const {
+		if (settings.pipelineCachePath.empty()) return;
+
+		size_t dataSize = 0;
+		vkGetPipelineCacheData(device.device, pipelineCache, &dataSize, nullptr);
+		std::vector<char> cacheData(dataSize);
+		if (vkGetPipelineCacheData(device.device, pipelineCache, &dataSize, cacheData.data()) !=
+		    VK_SUCCESS)
+			return;
+
+		VkPhysicalDeviceProperties deviceProperties;
+		vkGetPhysicalDeviceProperties(device.physicalDevice, &deviceProperties);
+		const PipelineCacheHeader header(deviceProperties, dataSize);
+
+		// written to a temporary file first so that an interrupted write never leaves a
+		// truncated cache behind
+		std::filesystem::path tempPath = settings.pipelineCachePath;
+		tempPath += ".tmp";
+
+		std::error_code error;
+		std::filesystem::create_directories(settings.pipelineCachePath.parent_path(), error);
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(cacheData.data(), dataSize);
+			if (!file) error = std::make_error_code(std::errc::io_error);
+		}
+		if (!error) std::filesystem::rename(tempPath, settings.pipelineCachePath, error);
+
+		if (error)
+			std::cerr << LOCATION "failed to save pipeline cache: " << error.message() << '\n';
 	}
 
-	VkShaderModule createShaderModule(const std::vector<char>& shaderCode) {
+	VkShaderModule createShaderModule(const std::vector<char>& shaderCode) const {
 		VkShaderModuleCreateInfo shaderModuleInfo = {};
 		shaderModuleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
 		shaderModuleInfo.codeSize = shaderCode.size();
@@ -1130,7 +2105,9 @@ private:
 		colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 		colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 		colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		// offscreen images are left ready to be copied out of
+		colorAttachment.finalLayout = settings.headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+		                                                : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
 		VkAttachmentReference colorAttachmentRef = {};
 		colorAttachmentRef.attachment = 0;
@@ -1141,28 +2118,132 @@ private:
 		subpass.colorAttachmentCount = 1;
 		subpass.pColorAttachments = &colorAttachmentRef;
 
-		VkSubpassDependency dependency = {};
-		dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-		dependency.dstSubpass = 0;
-		dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-		dependency.srcAccessMask = 0;
-		dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-		dependency.dstAccessMask =
+		std::array<VkSubpassDependency, 2> dependencies = {};
+		dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[0].dstSubpass = 0;
+		dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[0].srcAccessMask = 0;
+		dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[0].dstAccessMask =
 		    VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 
+		// the offscreen images are copied to the readback buffers after the render pass
+		dependencies[1].srcSubpass = 0;
+		dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
 		VkRenderPassCreateInfo renderPassInfo = {};
 		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
 		renderPassInfo.attachmentCount = 1;
 		renderPassInfo.pAttachments = &colorAttachment;
 		renderPassInfo.subpassCount = 1;
 		renderPassInfo.pSubpasses = &subpass;
-		renderPassInfo.dependencyCount = 1;
-		renderPassInfo.pDependencies = &dependency;
+		renderPassInfo.dependencyCount = settings.headless ? 2 : 1;
+		renderPassInfo.pDependencies = dependencies.data();
 
 		if (vkCreateRenderPass(device.device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
 			throw std::runtime_error(LOCATION "failed to create render pass!");
 	}
 
+	/**
+	 * Creates the render pass, layouts and shaders used by scaled modules the first time any
+	 * module is scaled
+	 */
+	void createUpscaleResources() {
+		if (!scaledModuleCount || upscalePipelineLayout != VK_NULL_HANDLE) return;
+
+		createScaledRenderPass();
+
+		VkDescriptorSetLayoutBinding moduleImageLayoutBinding = {};
+		moduleImageLayoutBinding.binding = 0;
+		moduleImageLayoutBinding.descriptorCount = 1;
+		moduleImageLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		moduleImageLayoutBinding.pImmutableSamplers = nullptr;
+		moduleImageLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = 1;
+		layoutInfo.pBindings = &moduleImageLayoutBinding;
+
+		if (vkCreateDescriptorSetLayout(device.device, &layoutInfo, nullptr,
+		                                &upscaleDescriptorSetLayout) != VK_SUCCESS)
+			throw std::runtime_error(LOCATION "failed to create descriptor set layout!");
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &upscaleDescriptorSetLayout;
+
+		if (vkCreatePipelineLayout(device.device, &pipelineLayoutInfo, nullptr,
+		                           &upscalePipelineLayout) != VK_SUCCESS)
+			throw std::runtime_error(LOCATION "failed to create pipeline layout!");
+
+		const auto modulesPath = settings.moduleLocations.front() / "modules";
+		upscalePipeline.vertShaderModule = createShaderModule(readFile(modulesPath / "vert.spv"));
+		upscalePipeline.fragShaderModule =
+		    createShaderModule(readFile(modulesPath / "upscale" / "frag.spv"));
+	}
+
+	/**
+	 * Creates the render pass scaled modules are drawn in, its attachment matches the one of the
+	 * main render pass, so the pipelines of the modules can be used in either
+	 */
+	void createScaledRenderPass() {
+		VkAttachmentDescription colorAttachment = {};
+		colorAttachment.format = swapChainImageFormat;
+		colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+		colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		VkAttachmentReference colorAttachmentRef = {};
+		colorAttachmentRef.attachment = 0;
+		colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+		VkSubpassDescription subpass = {};
+		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		subpass.colorAttachmentCount = 1;
+		subpass.pColorAttachments = &colorAttachmentRef;
+
+		// the image is read by the upscale draw of the frame, which has to finish before the
+		// next frame using the image clears it
+		std::array<VkSubpassDependency, 2> dependencies = {};
+		dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[0].dstSubpass = 0;
+		dependencies[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		dependencies[0].srcAccessMask = 0;
+		dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[0].dstAccessMask =
+		    VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+		dependencies[1].srcSubpass = 0;
+		dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+		VkRenderPassCreateInfo renderPassInfo = {};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+		renderPassInfo.attachmentCount = 1;
+		renderPassInfo.pAttachments = &colorAttachment;
+		renderPassInfo.subpassCount = 1;
+		renderPassInfo.pSubpasses = &subpass;
+		renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+		renderPassInfo.pDependencies = dependencies.data();
+
+		if (vkCreateRenderPass(device.device, &renderPassInfo, nullptr, &scaledRenderPass) !=
+		    VK_SUCCESS)
+			throw std::runtime_error(LOCATION "failed to create render pass!");
+	}
+
 	void createFramebuffers() {
 		swapChainFramebuffers.resize(swapChainImageViews.size());
 
@@ -1184,7 +2265,73 @@ private:
 		}
 	}
 
-	void createCommandPool() {
+	/**
+	 * Creates the images and framebuffers of the scaled modules, each frame in flight has its own
+	 * so that a frame never clears an image the previous one is still upscaling
+	 */
+	void createScaledImages() {
+		for (auto& module : modules) {
+			if (!module.scaled()) continue;
+
+			const VkExtent2D extent = moduleExtent(module);
+			for (size_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
+				Image& image = module.scaledImages[frame];
+				image = Image(device, extent.width, extent.height, VK_IMAGE_TYPE_2D,
+				              swapChainImageFormat, VK_IMAGE_TILING_OPTIMAL,
+				              VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+				              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+				image.view = createImageView(image.image, swapChainImageFormat);
+				image.sampler = createImageSampler();
+
+				VkFramebufferCreateInfo framebufferInfo = {};
+				framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+				framebufferInfo.renderPass = scaledRenderPass;
+				framebufferInfo.attachmentCount = 1;
+				framebufferInfo.pAttachments = &image.view;
+				framebufferInfo.width = extent.width;
+				framebufferInfo.height = extent.height;
+				framebufferInfo.layers = 1;
+
+				if (vkCreateFramebuffer(device.device, &framebufferInfo, nullptr,
+				                        &module.scaledFramebuffers[frame]) != VK_SUCCESS)
+					throw std::runtime_error(LOCATION "failed to create framebuffer!");
+			}
+		}
+	}
+
+	void destroyScaledImages() {
+		for (auto& module : modules) {
+			if (!module.scaled()) continue;
+			for (size_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
+				vkDestroyFramebuffer(device.device, module.scaledFramebuffers[frame], nullptr);
+				Image::destroy(module.scaledImages[frame]);
+			}
+		}
+	}
+
+	/**
+	 * Size the module is rendered at, scaled modules are never smaller than a pixel
+	 */
+	VkExtent2D moduleExtent(const Module& module) const {
+		if (!module.scaled()) return swapChainExtent;
+
+		return {std::max(1u, static_cast<uint32_t>(swapChainExtent.width * module.renderScale)),
+		        std::max(1u, static_cast<uint32_t>(swapChainExtent.height * module.renderScale))};
+	}
+
+	/**
+	 * Number of instances a module is drawn with, an instance every instanceSize pixels along
+	 * the diagonal of its extent plus one as the first may start before the edge
+	 */
+	uint32_t instanceCount(const Module& module) const {
+		if (!module.instanceSize) return 1;
+
+		const VkExtent2D extent = moduleExtent(module);
+		const double diagonal = std::hypot(extent.width, extent.height);
+		return static_cast<uint32_t>(std::ceil(diagonal / module.instanceSize.value())) + 1;
+	}
+
+	void createCommandPool() {
 		QueueFamilyIndices queueFamilyIndices = findQueueFamilies(device.physicalDevice);
 
 		VkCommandPoolCreateInfo poolInfo = {};
@@ -1196,59 +2343,359 @@ private:
 	}
 
 	void createCommandBuffers() {
-		commandBuffers.resize(swapChainFramebuffers.size());
+		for (size_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
+			commandBuffers[frame].resize(swapChainFramebuffers.size());
 
-		VkCommandBufferAllocateInfo allocInfo = {};
-		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-		allocInfo.commandPool = commandPool;
-		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		allocInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());
+			VkCommandBufferAllocateInfo allocInfo = {};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.commandPool = commandPool;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers[frame].size());
 
-		if (vkAllocateCommandBuffers(device.device, &allocInfo, commandBuffers.data()) !=
-		    VK_SUCCESS)
-			throw std::runtime_error(LOCATION "failed to allocate command buffers!");
+			if (vkAllocateCommandBuffers(device.device, &allocInfo,
+			                             commandBuffers[frame].data()) != VK_SUCCESS)
+				throw std::runtime_error(LOCATION "failed to allocate command buffers!");
 
-		for (size_t i = 0; i < commandBuffers.size(); ++i) {
-			VkCommandBufferBeginInfo beginInfo = {};
-			beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-			beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
-			beginInfo.pInheritanceInfo = nullptr;
+			for (size_t i = 0; i < commandBuffers[frame].size(); ++i)
+				recordCommandBuffer(commandBuffers[frame][i], frame, i);
+		}
+	}
 
-			if (vkBeginCommandBuffer(commandBuffers[i], &beginInfo) != VK_SUCCESS)
-				throw std::runtime_error(LOCATION "failed to begin recording command buffer!");
+	void recordCommandBuffer(VkCommandBuffer commandBuffer, size_t frame, size_t image) {
+		VkCommandBufferBeginInfo beginInfo = {};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+		beginInfo.pInheritanceInfo = nullptr;
+
+		if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+			throw std::runtime_error(LOCATION "failed to begin recording command buffer!");
+
+		if (stageAudio) recordAudioCopy(commandBuffer, frame);
+
+		VkClearValue clearColor = {{{0.0f, 0.0f, 0.0f, 0.0f}}};
+
+		if (settings.profile) vkCmdResetQueryPool(commandBuffer, queryPools[frame], 0, queryCount);
+
+		uint32_t query = 0;
+		if (settings.profile)
+			vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPools[frame],
+			                    query++);
+
+		if (analyseAudio) {
+			recordAnalysis(commandBuffer, frame);
+			if (settings.profile)
+				vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+				                    queryPools[frame], query++);
+		}
+
+		if (!smoothingPasses.empty()) {
+			recordSmoothing(commandBuffer, frame);
+			if (settings.profile)
+				vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+				                    queryPools[frame], query++);
+		}
+
+		if (useSpectrumImages) recordSpectrumCopies(commandBuffer, frame);
+
+		// scaled modules are drawn before the window's render pass, and upscaled in their place
+		// among the other modules
+		for (size_t module = 0; module < modules.size(); ++module) {
+			if (!modules[module].scaled()) continue;
 
 			VkRenderPassBeginInfo renderPassInfo = {};
 			renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-			renderPassInfo.renderPass = renderPass;
-			renderPassInfo.framebuffer = swapChainFramebuffers[i];
+			renderPassInfo.renderPass = scaledRenderPass;
+			renderPassInfo.framebuffer = modules[module].scaledFramebuffers[frame];
 			renderPassInfo.renderArea.offset = {0, 0};
-			renderPassInfo.renderArea.extent = swapChainExtent;
-			VkClearValue clearColor = {{{0.0f, 0.0f, 0.0f, 0.0f}}};
+			renderPassInfo.renderArea.extent = moduleExtent(modules[module]);
 			renderPassInfo.clearValueCount = 1;
 			renderPassInfo.pClearValues = &clearColor;
 
-			vkCmdBeginRenderPass(commandBuffers[i], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-			vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS,
-			                        pipelineLayouts[0], 0, 1, &commonDescriptorSets[i], 0, nullptr);
-			for (size_t module = 0; module < modules.size(); ++module) {
-				vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS,
-				                        pipelineLayouts[module], 1, 1, &descriptorSets[i][module],
-				                        0, nullptr);
-				for (const auto& layer : modules[module].layers) {
-					vkCmdBindPipeline(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS,
-					                  layer.graphicsPipeline);
-					vkCmdDraw(commandBuffers[i], modules[module].vertexCount, 1, 0, 0);
-				}
+			vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+			recordModule(commandBuffer, frame, module, query);
+			vkCmdEndRenderPass(commandBuffer);
+		}
+
+		VkRenderPassBeginInfo renderPassInfo = {};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+		renderPassInfo.renderPass = renderPass;
+		renderPassInfo.framebuffer = swapChainFramebuffers[image];
+		renderPassInfo.renderArea.offset = {0, 0};
+		renderPassInfo.renderArea.extent = swapChainExtent;
+		renderPassInfo.clearValueCount = 1;
+		renderPassInfo.pClearValues = &clearColor;
+
+		vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+		for (size_t module = 0; module < modules.size(); ++module) {
+			if (!modules[module].scaled()) {
+				recordModule(commandBuffer, frame, module, query);
+				continue;
 			}
 
-			vkCmdEndRenderPass(commandBuffers[i]);
+			setViewport(commandBuffer, swapChainExtent,
+			            moduleScissor(modules[module], swapChainExtent));
+			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+			                  upscalePipeline.graphicsPipeline);
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+			                        upscalePipelineLayout, 0, 1,
+			                        &modules[module].upscaleDescriptorSets[frame], 0, nullptr);
+			vkCmdDraw(commandBuffer, 6, 1, 0, 0);
+			if (settings.profile)
+				vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+				                    queryPools[frame], query++);
+		}
+
+		vkCmdEndRenderPass(commandBuffer);
+
+		if (settings.frameCallback) recordReadback(commandBuffer, frame, image);
 
-			if (vkEndCommandBuffer(commandBuffers[i]) != VK_SUCCESS)
-				throw std::runtime_error(LOCATION "failed to record command buffer!");
+		if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+			throw std::runtime_error(LOCATION "failed to record command buffer!");
+	}
+
+	/**
+	 * Records the layers of the module into the current render pass, each followed by a
+	 * timestamp when profiling
+	 */
+	void recordModule(VkCommandBuffer commandBuffer, size_t frame, size_t module,
+	                  uint32_t& query) {
+		const VkExtent2D extent = moduleExtent(modules[module]);
+		setViewport(commandBuffer, extent, moduleScissor(modules[module], extent));
+
+		const uint32_t uniformOffset = static_cast<uint32_t>(module * uniformStride);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+		                        pipelineLayouts[module], 0, 1,
+		                        &commonDescriptorSets[frame][modules[module].spectra], 1,
+		                        &uniformOffset);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+		                        pipelineLayouts[module], 1, 1, &descriptorSets[module], 0, nullptr);
+
+		for (const auto& layer : modules[module].layers) {
+			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+			                  layer.graphicsPipeline);
+			vkCmdDraw(commandBuffer, modules[module].vertexCount,
+			          instanceCount(modules[module]), 0, 0);
+			if (settings.profile)
+				vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+				                    queryPools[frame], query++);
 		}
 	}
 
+	void setViewport(VkCommandBuffer commandBuffer, VkExtent2D extent,
+	                 std::optional<VkRect2D> scissor = std::nullopt) {
+		VkViewport viewport = {};
+		viewport.x = 0.0f;
+		viewport.y = 0.0f;
+		viewport.width = static_cast<float>(extent.width);
+		viewport.height = static_cast<float>(extent.height);
+		viewport.minDepth = 0.0f;
+		viewport.maxDepth = 1.0f;
+		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+		const VkRect2D rect = scissor.value_or(VkRect2D{{0, 0}, extent});
+		vkCmdSetScissor(commandBuffer, 0, 1, &rect);
+	}
+
+	/**
+	 * Scissor covering the bounds of the module within the target extent, the bounds are
+	 * evaluated in pixels of the extent the module is rendered at and scaled to the target, which
+	 * differs when the module is upscaled into the window
+	 */
+	VkRect2D moduleScissor(const Module& module, VkExtent2D target) const {
+		if (!module.bounds) return {{0, 0}, target};
+
+		const VkExtent2D extent = moduleExtent(module);
+		std::unordered_map<std::string, float> variables = module.parameters;
+		variables["width"] = static_cast<float>(extent.width);
+		variables["height"] = static_cast<float>(extent.height);
+
+		std::array<float, 4> bounds;
+		for (size_t i = 0; i < bounds.size(); ++i)
+			bounds[i] = calculate<float>(module.bounds.value()[i], variables);
+
+		const float xScale = static_cast<float>(target.width) / extent.width;
+		const float yScale = static_cast<float>(target.height) / extent.height;
+		const auto clamp = [](float value, uint32_t size) {
+			return static_cast<int32_t>(std::clamp(value, 0.f, static_cast<float>(size)));
+		};
+
+		const int32_t left = clamp(std::floor(bounds[0] * xScale), target.width);
+		const int32_t top = clamp(std::floor(bounds[1] * yScale), target.height);
+		const int32_t right = clamp(std::ceil((bounds[0] + bounds[2]) * xScale), target.width);
+		const int32_t bottom = clamp(std::ceil((bounds[1] + bounds[3]) * yScale), target.height);
+
+		VkRect2D scissor = {};
+		scissor.offset = {left, top};
+		scissor.extent = {static_cast<uint32_t>(std::max(right - left, 0)),
+		                  static_cast<uint32_t>(std::max(bottom - top, 0))};
+		return scissor;
+	}
+
+	void createQueryPools() {
+		QueueFamilyIndices indices = findQueueFamilies(device.physicalDevice);
+
+		uint32_t queueFamilyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(device.physicalDevice, &queueFamilyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(device.physicalDevice, &queueFamilyCount,
+		                                         queueFamilies.data());
+
+		const uint32_t validBits = queueFamilies[indices.graphicsFamily.value()].timestampValidBits;
+		if (validBits == 0) {
+			std::cerr << LOCATION "timestamp queries not supported by the selected GPU!\n";
+			settings.profile = false;
+			return;
+		}
+		timestampMask = validBits < 64 ? (uint64_t(1) << validBits) - 1
+		                               : std::numeric_limits<uint64_t>::max();
+
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(device.physicalDevice, &properties);
+		timestampPeriod = properties.limits.timestampPeriod;
+
+		moduleTimes.resize(modules.size());
+		layerTimes.resize(modules.size());
+		for (size_t module = 0; module < modules.size(); ++module)
+			layerTimes[module].resize(modules[module].layers.size());
+		updateQueryCount();
+
+		// the pools fit the timestamps of every module being scaled and of the smoothing passes, so
+		// that changing the quality never recreates them
+		VkQueryPoolCreateInfo poolInfo = {};
+		poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		poolInfo.queryCount =
+		    queryCount + static_cast<uint32_t>(modules.size() - scaledModuleCount) +
+		    (smoothingPasses.empty() ? 1 : 0);
+
+		for (auto& queryPool : queryPools)
+			if (vkCreateQueryPool(device.device, &poolInfo, nullptr, &queryPool) != VK_SUCCESS)
+				throw std::runtime_error(LOCATION "failed to create query pool!");
+	}
+
+	// scaled modules have an extra timestamp after being upscaled, the gpu analysis has one and
+	// the smoothing passes one for all of them
+	void updateQueryCount() {
+		queryCount = 1 + static_cast<uint32_t>(scaledModuleCount);
+		if (analyseAudio) ++queryCount;
+		if (!smoothingPasses.empty()) ++queryCount;
+		for (auto& module : modules) queryCount += static_cast<uint32_t>(module.layers.size());
+	}
+
+	/**
+	 * Sets the cpu time of the frame started at frameStart, leaving out the time it waited
+	 */
+	void updateCpuTime(std::chrono::steady_clock::time_point frameStart,
+	                   std::chrono::steady_clock::duration waited) {
+		const std::chrono::duration<float, std::milli> time =
+		    std::chrono::steady_clock::now() - frameStart - waited;
+		cpuTime = time.count();
+	}
+
+	/**
+	 * Adds the gpu times of the frame rendered in the given slot to the statistics, the fence of
+	 * the slot has to be signaled so the results are read without waiting
+	 */
+	void collectTimestamps(size_t frame) {
+		if (!queriesPending[frame]) return;
+		queriesPending[frame] = false;
+
+		std::vector<uint64_t> timestamps(queryCount);
+		if (vkGetQueryPoolResults(device.device, queryPools[frame], 0, queryCount,
+		                          timestamps.size() * sizeof(uint64_t), timestamps.data(),
+		                          sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+			return;
+
+		frameTime =
+		    ((timestamps.back() - timestamps.front()) & timestampMask) * timestampPeriod / 1e6f;
+
+		// the timestamps are in the order they were recorded, the analysis, smoothing and scaled
+		// modules first
+		size_t query = 0;
+		const auto nextTime = [&]() {
+			const uint64_t ticks = (timestamps[query + 1] - timestamps[query]) & timestampMask;
+			++query;
+			return ticks * timestampPeriod / 1e6f;
+		};
+
+		if (analyseAudio) analysisTimes.add(nextTime());
+		if (!smoothingPasses.empty()) smoothingTimes.add(nextTime());
+
+		std::vector<float> moduleTime(modules.size(), 0.f);
+		const auto addLayers = [&](size_t module) {
+			for (auto& layerTime : layerTimes[module]) {
+				const float time = nextTime();
+				layerTime.add(time);
+				moduleTime[module] += time;
+			}
+		};
+
+		for (size_t module = 0; module < modules.size(); ++module)
+			if (modules[module].scaled()) addLayers(module);
+
+		for (size_t module = 0; module < modules.size(); ++module) {
+			if (modules[module].scaled())
+				moduleTime[module] += nextTime();
+			else
+				addLayers(module);
+
+			moduleTimes[module].add(moduleTime[module]);
+		}
+	}
+
+	void createReadbackBuffers() {
+		for (size_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
+			readbackBuffers[frame] =
+			    Buffer(device, 4 * swapChainExtent.width * swapChainExtent.height,
+			           VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+			readbackData[frame] =
+			    reinterpret_cast<unsigned char*>(readbackBuffers[frame].mapMemory());
+		}
+	}
+
+	void recordReadback(VkCommandBuffer commandBuffer, size_t frame, size_t image) {
+		VkBufferImageCopy region = {};
+		region.bufferOffset = 0;
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = {0, 0, 0};
+		region.imageExtent = {swapChainExtent.width, swapChainExtent.height, 1};
+
+		vkCmdCopyImageToBuffer(commandBuffer, swapChainImages[image],
+		                       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readbackBuffers[frame].buffer,
+		                       1, &region);
+
+		VkBufferMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer = readbackBuffers[frame].buffer;
+		barrier.offset = 0;
+		barrier.size = VK_WHOLE_SIZE;
+
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+		                     VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+	}
+
+	/**
+	 * Hands the pixels of the frame rendered in the given slot to the frame callback, the fence
+	 * of the slot has to be signaled
+	 */
+	void finishReadback(size_t frame) {
+		if (!readbackPending[frame]) return;
+
+		readbackPending[frame] = false;
+		settings.frameCallback(readbackData[frame]);
+	}
+
 	void createSyncObjects() {
 		VkSemaphoreCreateInfo semaphoreInfo = {};
 		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -1271,17 +2718,23 @@ private:
 		for (auto framebuffer : swapChainFramebuffers)
 			vkDestroyFramebuffer(device.device, framebuffer, nullptr);
 
-		vkFreeCommandBuffers(device.device, commandPool,
-		                     static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+		for (auto& frameCommandBuffers : commandBuffers)
+			vkFreeCommandBuffers(device.device, commandPool,
+			                     static_cast<uint32_t>(frameCommandBuffers.size()),
+			                     frameCommandBuffers.data());
 
-		for (size_t i = 0; i < modules.size(); ++i)
-			for (auto& graphicsPipeline : modules[i].layers)
-				vkDestroyPipeline(device.device, graphicsPipeline.graphicsPipeline, nullptr);
+		destroyGraphicsPipelines(true);
+		destroyScaledImages();
 
 		for (auto imageView : swapChainImageViews)
 			vkDestroyImageView(device.device, imageView, nullptr);
 
-		vkDestroySwapchainKHR(device.device, swapChain, nullptr);
+		if (settings.headless) {
+			for (auto& image : offscreenImages) Image::destroy(image);
+			offscreenImages.clear();
+		} else {
+			vkDestroySwapchainKHR(device.device, swapChain, nullptr);
+		}
 	}
 
 	void recreateSwapChain() {
@@ -1293,8 +2746,10 @@ private:
 
 		createSwapchain();
 		createImageViews();
-		createGraphicsPipelines();
+		createGraphicsPipelines(true);
 		createFramebuffers();
+		createScaledImages();
+		updateUpscaleDescriptorSets();
 		createCommandBuffers();
 	}
 
@@ -1443,11 +2898,12 @@ private:
 		endSingleTimeCommands(commandBuffer);
 	}
 
-	VkImageView createImageView(VkImage image, VkFormat format) {
+	VkImageView createImageView(VkImage image, VkFormat format,
+	                            VkImageViewType viewType = VK_IMAGE_VIEW_TYPE_2D) {
 		VkImageViewCreateInfo viewInfo = {};
 		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
 		viewInfo.image = image;
-		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.viewType = viewType;
 		viewInfo.format = format;
 		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 		viewInfo.subresourceRange.baseMipLevel = 0;
@@ -1462,11 +2918,11 @@ private:
 		return imageView;
 	}
 
-	VkSampler createImageSampler() {
+	VkSampler createImageSampler(VkFilter filter = VK_FILTER_LINEAR) {
 		VkSamplerCreateInfo samplerInfo = {};
 		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-		samplerInfo.magFilter = VK_FILTER_LINEAR;
-		samplerInfo.minFilter = VK_FILTER_LINEAR;
+		samplerInfo.magFilter = filter;
+		samplerInfo.minFilter = filter;
 		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
 		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
 		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
@@ -1492,7 +2948,8 @@ private:
 		{
 			VkDescriptorSetLayoutBinding dataLayoutBinding = {};
 			dataLayoutBinding.binding = 0;
-			dataLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+			// offset to the uniform buffer object of the module being drawn
+			dataLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 			dataLayoutBinding.descriptorCount = 1;
 			dataLayoutBinding.pImmutableSamplers = nullptr;
 			dataLayoutBinding.stageFlags =
@@ -1523,10 +2980,27 @@ private:
 			backgroundSamplerLayoutBinding.stageFlags =
 			    VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 
-			std::array<VkDescriptorSetLayoutBinding, 4> bindings = {
+			std::vector<VkDescriptorSetLayoutBinding> bindings = {
 			    dataLayoutBinding, lAudioBufferLayoutBinding, rAudioBufferLayoutBinding,
 			    backgroundSamplerLayoutBinding};
 
+			// the spectra as 1D images follow the texel buffers, which stay where they were for
+			// the modules reading them
+			if (useSpectrumImages) {
+				VkDescriptorSetLayoutBinding spectrumImageLayoutBinding = {};
+				spectrumImageLayoutBinding.descriptorCount = 1;
+				spectrumImageLayoutBinding.descriptorType =
+				    VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+				spectrumImageLayoutBinding.pImmutableSamplers = nullptr;
+				spectrumImageLayoutBinding.stageFlags =
+				    VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+				for (uint32_t channel = 0; channel < 2; ++channel) {
+					spectrumImageLayoutBinding.binding = 4 + channel;
+					bindings.push_back(spectrumImageLayoutBinding);
+				}
+			}
+
 			VkDescriptorSetLayoutCreateInfo layoutInfo = {};
 			layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
 			layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
@@ -1558,80 +3032,479 @@ private:
 			                                &descriptorSetLayouts[module]) != VK_SUCCESS)
 				throw std::runtime_error(LOCATION "failed to create descriptor set layout!");
 		}
+
+		{
+			VkDescriptorSetLayoutBinding spectrumLayoutBinding = {};
+			spectrumLayoutBinding.binding = 0;
+			spectrumLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+			spectrumLayoutBinding.descriptorCount = 1;
+			spectrumLayoutBinding.pImmutableSamplers = nullptr;
+			spectrumLayoutBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+			VkDescriptorSetLayoutBinding smoothedLayoutBinding = {};
+			smoothedLayoutBinding.binding = 1;
+			smoothedLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			smoothedLayoutBinding.descriptorCount = 1;
+			smoothedLayoutBinding.pImmutableSamplers = nullptr;
+			smoothedLayoutBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+			std::array<VkDescriptorSetLayoutBinding, 2> bindings = {spectrumLayoutBinding,
+			                                                        smoothedLayoutBinding};
+
+			VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+			layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+			layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+			layoutInfo.pBindings = bindings.data();
+
+			if (vkCreateDescriptorSetLayout(device.device, &layoutInfo, nullptr,
+			                                &smoothingDescriptorSetLayout) != VK_SUCCESS)
+				throw std::runtime_error(LOCATION "failed to create descriptor set layout!");
+		}
+
+		if (settings.gpuAnalysis) {
+			// the slice of the frame and the intermediate results
+			std::array<VkDescriptorSetLayoutBinding, 2> bindings = {};
+			for (uint32_t binding = 0; binding < bindings.size(); ++binding) {
+				bindings[binding].binding = binding;
+				bindings[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+				bindings[binding].descriptorCount = 1;
+				bindings[binding].pImmutableSamplers = nullptr;
+				bindings[binding].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+			}
+
+			VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+			layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+			layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+			layoutInfo.pBindings = bindings.data();
+
+			if (vkCreateDescriptorSetLayout(device.device, &layoutInfo, nullptr,
+			                                &analysisDescriptorSetLayout) != VK_SUCCESS)
+				throw std::runtime_error(LOCATION "failed to create descriptor set layout!");
+		}
 	}
 
 	void createAudioBuffers() {
-		VkDeviceSize bufferSize = settings.audioSize * sizeof(float);
+		VkPhysicalDeviceProperties deviceProperties;
+		vkGetPhysicalDeviceProperties(device.physicalDevice, &deviceProperties);
+
+		// every part of a slice has to be usable as a uniform, storage and texel buffer offset
+		const VkDeviceSize alignment =
+		    std::max({deviceProperties.limits.minUniformBufferOffsetAlignment,
+		              deviceProperties.limits.minStorageBufferOffsetAlignment,
+		              deviceProperties.limits.minTexelBufferOffsetAlignment});
+		const auto align = [alignment](VkDeviceSize offset) {
+			return (offset + alignment - 1) / alignment * alignment;
+		};
+
+		const VkDeviceSize audioSize = settings.audioSize * sizeof(float);
+		uniformStride = align(sizeof(UniformBufferObject));
+		lAudioOffset = modules.size() * uniformStride;
+		rAudioOffset = align(lAudioOffset + audioSize);
+		samplesOffset = align(rAudioOffset + audioSize);
+		uploadSliceSize = samplesOffset;
+		if (settings.gpuAnalysis)
+			uploadSliceSize = align(samplesOffset + settings.gpuAnalysis->channels *
+			                                            settings.gpuAnalysis->size * sizeof(float));
+
+		// the gpu analysis writes to the slices, which are copied back to the upload buffer when
+		// it is checked against the cpu
+		VkBufferUsageFlags shaderUsage =
+		    VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT;
+		VkBufferUsageFlags uploadUsage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+		VkBufferUsageFlags deviceUsage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		VkBufferUsageFlags smoothedUsage =
+		    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT;
+		if (useSpectrumImages) {
+			shaderUsage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+			smoothedUsage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+		}
+		if (settings.gpuAnalysis) {
+			shaderUsage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+			uploadUsage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+			deviceUsage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+		}
 
-		dataBuffers.resize(swapChainImages.size());
+		stageAudio = !device.unifiedMemory();
+		if (stageAudio) std::clog << "Staging audio through device local memory" << std::endl;
 
-		lAudioBuffers.resize(swapChainImages.size());
-		rAudioBuffers.resize(swapChainImages.size());
+		uploadBuffer = Buffer(
+		    device, MAX_FRAMES_IN_FLIGHT * uploadSliceSize, stageAudio ? uploadUsage : shaderUsage,
+		    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		uploadData = reinterpret_cast<char*>(uploadBuffer.mapMemory());
 
-		for (size_t i = 0; i < dataBuffers.size(); ++i) {
-			dataBuffers[i] =
-			    Buffer(device, sizeof(UniformBufferObject), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-			           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		if (stageAudio)
+			deviceAudioBuffer =
+			    Buffer(device, MAX_FRAMES_IN_FLIGHT * uploadSliceSize, shaderUsage | deviceUsage,
+			           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-			lAudioBuffers[i] =
-			    Buffer(device, bufferSize, VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT,
-			           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+			shaderAudioBuffer().createBufferView(VK_FORMAT_R32_SFLOAT,
+			                                     i * uploadSliceSize + lAudioOffset, audioSize);
+			shaderAudioBuffer().createBufferView(VK_FORMAT_R32_SFLOAT,
+			                                     i * uploadSliceSize + rAudioOffset, audioSize);
+		}
+
+		// there are never more distinct smoothing passes than modules, so the buffer is never
+		// recreated when the smoothing levels change
+		smoothedStride = align(audioSize);
+		const size_t smoothedCount = MAX_FRAMES_IN_FLIGHT * modules.size() * 2;
+		smoothedBuffer = Buffer(device, smoothedCount * smoothedStride, smoothedUsage,
+		                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		for (size_t i = 0; i < smoothedCount; ++i)
+			smoothedBuffer.createBufferView(VK_FORMAT_R32_SFLOAT, i * smoothedStride, audioSize);
+
+		if (settings.gpuAnalysis) {
+			// two arrays of complex numbers and the magnitudes of both channels
+			analysisStride = align(5 * settings.gpuAnalysis->size * sizeof(float));
+			analysisBuffer =
+			    Buffer(device, MAX_FRAMES_IN_FLIGHT * analysisStride,
+			           VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		}
+	}
 
-			lAudioBuffers[i].createBufferView(VK_FORMAT_R32_SFLOAT);
+	/**
+	 * The smoothing helpers fetch two weighted bins at once, which only works with linear
+	 * filtering. Without it the modules are told to read the texel buffers instead.
+	 */
+	bool spectrumImagesFilterable() const {
+		VkFormatProperties formatProperties;
+		vkGetPhysicalDeviceFormatProperties(device.physicalDevice, VK_FORMAT_R32_SFLOAT,
+		                                    &formatProperties);
+		if (formatProperties.optimalTilingFeatures &
+		    VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+			return true;
+
+		std::clog << "Spectrum images can't be filtered linearly on this device, modules will "
+		             "read the texel buffers instead"
+		          << std::endl;
+		return false;
+	}
 
-			rAudioBuffers[i] =
-			    Buffer(device, bufferSize, VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT,
-			           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	/**
+	 * Creates a 1D image for every frame in flight, spectra and channel, and the sampler they
+	 * share
+	 */
+	void createSpectrumImages() {
+		VkPhysicalDeviceProperties deviceProperties;
+		vkGetPhysicalDeviceProperties(device.physicalDevice, &deviceProperties);
+		if (settings.audioSize > deviceProperties.limits.maxImageDimension1D)
+			throw std::runtime_error(LOCATION "audioSize too large for spectrum images!");
+
+		// images that can't be filtered are only bound because the modules declare them
+		const VkFormat format = VK_FORMAT_R32_SFLOAT;
+		spectrumSampler =
+		    createImageSampler(filterSpectrumImages ? VK_FILTER_LINEAR : VK_FILTER_NEAREST);
+
+		spectrumImages.resize(MAX_FRAMES_IN_FLIGHT * (1 + modules.size()) * 2);
+		for (auto& image : spectrumImages) {
+			image = Image(device, static_cast<uint32_t>(settings.audioSize), 1, VK_IMAGE_TYPE_1D,
+			              format, VK_IMAGE_TILING_OPTIMAL,
+			              VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+			              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+			image.view = createImageView(image.image, format, VK_IMAGE_VIEW_TYPE_1D);
+		}
+	}
+
+	/**
+	 * Index of the spectrum image holding a channel of the spectra of a frame
+	 */
+	size_t spectrumImageIndex(size_t frame, size_t spectra, size_t channel) const {
+		return (frame * (1 + modules.size()) + spectra) * 2 + channel;
+	}
+
+	/**
+	 * Copies the spectra read by the modules using spectrum images from the buffers the analysis
+	 * and smoothing passes left them in, and makes them visible to the modules
+	 */
+	void recordSpectrumCopies(VkCommandBuffer commandBuffer, size_t frame) {
+		std::vector<size_t> spectra;
+		for (const auto& module : modules)
+			if (module.spectrumImages &&
+			    std::find(spectra.begin(), spectra.end(), module.spectra) == spectra.end())
+				spectra.push_back(module.spectra);
+
+		VkImageMemoryBarrier imageBarrier = {};
+		imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		imageBarrier.subresourceRange.baseMipLevel = 0;
+		imageBarrier.subresourceRange.levelCount = 1;
+		imageBarrier.subresourceRange.baseArrayLayer = 0;
+		imageBarrier.subresourceRange.layerCount = 1;
+
+		// the previous contents are overwritten, so the images start out undefined every frame
+		std::vector<VkImageMemoryBarrier> imageBarriers;
+		imageBarrier.srcAccessMask = 0;
+		imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		imageBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		for (size_t index : spectra) {
+			for (size_t channel = 0; channel < 2; ++channel) {
+				imageBarrier.image =
+				    spectrumImages[spectrumImageIndex(frame, index, channel)].image;
+				imageBarriers.push_back(imageBarrier);
+			}
+		}
+
+		// the spectra are written by the audio copy, the analysis or the smoothing passes
+		VkMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+		vkCmdPipelineBarrier(commandBuffer,
+		                     VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		                     VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr,
+		                     static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+
+		VkBufferImageCopy region = {};
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = {0, 0, 0};
+		region.imageExtent = {static_cast<uint32_t>(settings.audioSize), 1, 1};
+
+		for (size_t index : spectra) {
+			for (size_t channel = 0; channel < 2; ++channel) {
+				const Buffer& buffer = index ? smoothedBuffer : shaderAudioBuffer();
+				region.bufferOffset =
+				    index ? smoothedIndex(frame, index - 1, channel) * smoothedStride
+				          : frame * uploadSliceSize + (channel ? rAudioOffset : lAudioOffset);
+
+				vkCmdCopyBufferToImage(
+				    commandBuffer, buffer.buffer,
+				    spectrumImages[spectrumImageIndex(frame, index, channel)].image,
+				    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+			}
+		}
 
-			rAudioBuffers[i].createBufferView(VK_FORMAT_R32_SFLOAT);
+		for (auto& transition : imageBarriers) {
+			transition.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			transition.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			transition.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			transition.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 		}
+
+		vkCmdPipelineBarrier(
+		    commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+		    VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0,
+		    nullptr, 0, nullptr, static_cast<uint32_t>(imageBarriers.size()),
+		    imageBarriers.data());
+	}
+
+	/**
+	 * Index of the part of the smoothed buffer a channel of a smoothing pass is written to
+	 */
+	size_t smoothedIndex(size_t frame, size_t pass, size_t channel) const {
+		return (frame * modules.size() + pass) * 2 + channel;
 	}
 
-	void updateAudioBuffers(const AudioData& audioData, uint32_t currentFrame) {
+	/**
+	 * Smooths both channels for every smoothing pass, and makes the results visible to the
+	 * modules
+	 */
+	void recordSmoothing(VkCommandBuffer commandBuffer, size_t frame) {
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, smoothingPipeline);
+
+		const uint32_t groupCount = static_cast<uint32_t>((settings.audioSize + 63) / 64);
+		for (size_t pass = 0; pass < smoothingPasses.size(); ++pass) {
+			const SmoothingPushConstants pushConstants = {smoothingPasses[pass].level,
+			                                              smoothingPasses[pass].kernel};
+			vkCmdPushConstants(commandBuffer, smoothingPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT,
+			                   0, sizeof(pushConstants), &pushConstants);
+
+			for (size_t channel = 0; channel < 2; ++channel) {
+				vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+				                        smoothingPipelineLayout, 0, 1,
+				                        &smoothingDescriptorSets[frame][2 * pass + channel], 0,
+				                        nullptr);
+				vkCmdDispatch(commandBuffer, groupCount, 1, 1);
+			}
+		}
+
+		VkBufferMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer = smoothedBuffer.buffer;
+		barrier.offset = smoothedIndex(frame, 0, 0) * smoothedStride;
+		barrier.size = smoothedStride * 2 * smoothingPasses.size();
+
+		vkCmdPipelineBarrier(
+		    commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		    VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0,
+		    nullptr, 1, &barrier, 0, nullptr);
+	}
+
+	/**
+	 * Windows the samples of the frame, transforms them with a dispatch for every stage of the fft
+	 * and writes the spectra and the volumes of every module to the frame's slice, where the
+	 * modules and the smoothing passes read them
+	 */
+	void recordAnalysis(VkCommandBuffer commandBuffer, size_t frame) {
+		const auto& analysis = settings.gpuAnalysis.value();
+
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, analysisPipeline);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+		                        analysisPipelineLayout, 0, 1, &analysisDescriptorSets[frame], 0,
+		                        nullptr);
+
+		AnalysisPushConstants pushConstants = {};
+		pushConstants.size = static_cast<uint32_t>(analysis.size);
+		pushConstants.channels = analysis.channels;
+		pushConstants.audioSize = static_cast<uint32_t>(settings.audioSize);
+		pushConstants.samples = static_cast<uint32_t>(samplesOffset / sizeof(float));
+		pushConstants.lAudio = static_cast<uint32_t>(lAudioOffset / sizeof(float));
+		pushConstants.rAudio = static_cast<uint32_t>(rAudioOffset / sizeof(float));
+		pushConstants.uniformStride = static_cast<uint32_t>(uniformStride / sizeof(float));
+		pushConstants.moduleCount = static_cast<uint32_t>(modules.size());
+		pushConstants.amplitude = analysis.amplitude;
+
+		const auto dispatch = [&](AnalysisStep step, uint32_t stage, size_t invocations) {
+			pushConstants.step = step;
+			pushConstants.stage = stage;
+			vkCmdPushConstants(commandBuffer, analysisPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT,
+			                   0, sizeof(pushConstants), &pushConstants);
+			vkCmdDispatch(commandBuffer, static_cast<uint32_t>((invocations + 63) / 64), 1, 1);
+		};
+
+		// every step reads what the previous one wrote
+		VkMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		const auto wait = [&]() {
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr,
+			                     0, nullptr);
+		};
+
+		uint32_t stages = 0;
+		while ((size_t(1) << stages) < analysis.size) ++stages;
+
+		dispatch(AnalysisStep::window, 0, analysis.size);
+		wait();
+		for (uint32_t stage = 0; stage < stages; ++stage) {
+			dispatch(AnalysisStep::butterfly, stage, analysis.size / 2);
+			wait();
+		}
+		dispatch(AnalysisStep::magnitude, stages, analysis.size / 2);
+		wait();
+		// the volumes are summed by a single workgroup
+		dispatch(AnalysisStep::volume, 0, 1);
+
+		barrier.dstAccessMask = VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+		                         VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+		                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+		                     0, 1, &barrier, 0, nullptr, 0, nullptr);
+	}
+
+	Buffer& shaderAudioBuffer() { return stageAudio ? deviceAudioBuffer : uploadBuffer; }
+
+	/**
+	 * Copies the slice of the frame to device local memory and makes it visible to the shaders
+	 */
+	void recordAudioCopy(VkCommandBuffer commandBuffer, size_t frame) {
+		VkBufferCopy copyRegion = {};
+		copyRegion.srcOffset = frame * uploadSliceSize;
+		copyRegion.dstOffset = frame * uploadSliceSize;
+		copyRegion.size = uploadSliceSize;
+		vkCmdCopyBuffer(commandBuffer, uploadBuffer.buffer, deviceAudioBuffer.buffer, 1,
+		                &copyRegion);
+
+		VkBufferMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+		// the gpu analysis overwrites the spectra and volumes that were copied
+		if (analyseAudio) barrier.dstAccessMask |= VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer = deviceAudioBuffer.buffer;
+		barrier.offset = copyRegion.dstOffset;
+		barrier.size = copyRegion.size;
+
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+		                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+		                         VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+		                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+		                     0, 0, nullptr, 1, &barrier, 0, nullptr);
+	}
+
+	/**
+	 * Writes the audio to the slice of the upload buffer belonging to the frame, the fence of the
+	 * frame guarantees that the gpu is no longer reading it
+	 */
+	void updateAudioBuffers(const AudioData& audioData, size_t frame,
+	                        std::optional<std::chrono::milliseconds> time) {
 		static const auto startTime = std::chrono::high_resolution_clock::now();
 		const auto currentTime = std::chrono::high_resolution_clock::now();
-		void* data;
 
-		data = dataBuffers[currentFrame].mapMemory();
-		reinterpret_cast<UniformBufferObject*>(data)->lVolume = audioData.lVolume;
-		reinterpret_cast<UniformBufferObject*>(data)->rVolume = audioData.rVolume;
-		reinterpret_cast<UniformBufferObject*>(data)->time =
-		    std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - startTime).count();
-		dataBuffers[currentFrame].unmapMemory();
+		char* slice = uploadData + frame * uploadSliceSize;
+
+		UniformBufferObject ubo;
+		ubo.lVolume = audioData.lVolume;
+		ubo.rVolume = audioData.rVolume;
+		ubo.time = time.value_or(std::chrono::duration_cast<std::chrono::milliseconds>(
+		                             currentTime - startTime))
+		               .count();
+		for (size_t module = 0; module < modules.size(); ++module) {
+			const VkExtent2D extent = moduleExtent(modules[module]);
+			ubo.width = extent.width;
+			ubo.height = extent.height;
+			std::memcpy(slice + module * uniformStride, &ubo, sizeof(ubo));
+		}
 
-		data = lAudioBuffers[currentFrame].mapMemory();
-		std::copy_n(audioData.lBuffer, settings.audioSize, reinterpret_cast<float*>(data));
-		lAudioBuffers[currentFrame].unmapMemory();
+		if (analyseAudio) {
+			const auto& analysis = settings.gpuAnalysis.value();
+			std::copy_n(audioData.buffer, analysis.channels * analysis.size,
+			            reinterpret_cast<float*>(slice + samplesOffset));
+			return;
+		}
 
-		data = rAudioBuffers[currentFrame].mapMemory();
-		std::copy_n(audioData.rBuffer, settings.audioSize, reinterpret_cast<float*>(data));
-		rAudioBuffers[currentFrame].unmapMemory();
+		std::copy_n(audioData.lBuffer, settings.audioSize,
+		            reinterpret_cast<float*>(slice + lAudioOffset));
+		std::copy_n(audioData.rBuffer, settings.audioSize,
+		            reinterpret_cast<float*>(slice + rAudioOffset));
 	}
 
 	void createDescriptorPool() {
-		std::array<VkDescriptorPoolSize, 4> poolSizes = {};
-		poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		poolSizes[0].descriptorCount =
-		    static_cast<uint32_t>(swapChainImages.size() * modules.size());
+		size_t resourceCount = 0;
+		for (auto& module : modules) resourceCount += module.images.size();
+		const size_t upscaleSetCount = MAX_FRAMES_IN_FLIGHT * scaledModuleCount;
+		const size_t commonSetCount = MAX_FRAMES_IN_FLIGHT * (1 + smoothingPasses.size());
+		const size_t smoothingSetCount = MAX_FRAMES_IN_FLIGHT * 2 * smoothingPasses.size();
+		const size_t analysisSetCount = settings.gpuAnalysis ? MAX_FRAMES_IN_FLIGHT : 0;
+		const size_t storageCount = smoothingSetCount + 2 * analysisSetCount;
+
+		std::vector<VkDescriptorPoolSize> poolSizes(3);
+		poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		poolSizes[0].descriptorCount = static_cast<uint32_t>(commonSetCount);
 		poolSizes[1].type = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
 		poolSizes[1].descriptorCount =
-		    static_cast<uint32_t>(swapChainImages.size() * modules.size());
-		poolSizes[2].type = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+		    static_cast<uint32_t>(2 * commonSetCount + smoothingSetCount);
+		poolSizes[2].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 		poolSizes[2].descriptorCount =
-		    static_cast<uint32_t>(swapChainImages.size() * modules.size());
-
-		size_t resourceCount = 0;
-		for (auto& module : modules) resourceCount += module.images.size();
-
-		poolSizes[3].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		poolSizes[3].descriptorCount =
-		    static_cast<uint32_t>(swapChainImages.size() * (resourceCount + modules.size()));
+		    static_cast<uint32_t>((useSpectrumImages ? 3 : 1) * commonSetCount + resourceCount +
+		                          upscaleSetCount);
+		if (storageCount)
+			poolSizes.push_back(
+			    {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, static_cast<uint32_t>(storageCount)});
 
 		VkDescriptorPoolCreateInfo poolInfo = {};
 		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
 		poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
 		poolInfo.pPoolSizes = poolSizes.data();
-		poolInfo.maxSets = static_cast<uint32_t>(swapChainImages.size() * 2 * modules.size());
+		poolInfo.maxSets = static_cast<uint32_t>(commonSetCount + modules.size() + upscaleSetCount +
+		                                         smoothingSetCount + analysisSetCount);
 
 		if (vkCreateDescriptorPool(device.device, &poolInfo, nullptr, &descriptorPool) !=
 		    VK_SUCCESS)
@@ -1645,100 +3518,281 @@ private:
 		allocInfo.descriptorSetCount = static_cast<uint32_t>(descriptorSetLayouts.size());
 		allocInfo.pSetLayouts = descriptorSetLayouts.data();
 
+		const std::vector<VkDescriptorSetLayout> commonLayouts(1 + smoothingPasses.size(),
+		                                                       commonDescriptorSetLayout);
+
 		VkDescriptorSetAllocateInfo commonAllocInfo = {};
 		commonAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
 		commonAllocInfo.descriptorPool = descriptorPool;
-		commonAllocInfo.descriptorSetCount = 1;
-		commonAllocInfo.pSetLayouts = &commonDescriptorSetLayout;
-
-		commonDescriptorSets.resize(swapChainImages.size());
-		descriptorSets.resize(swapChainImages.size());
+		commonAllocInfo.descriptorSetCount = static_cast<uint32_t>(commonLayouts.size());
+		commonAllocInfo.pSetLayouts = commonLayouts.data();
 
-		for (size_t i = 0; i < swapChainImages.size(); ++i) {
-			descriptorSets[i].resize(modules.size());
+		descriptorSets.resize(modules.size());
 
+		for (auto& frameDescriptorSets : commonDescriptorSets) {
+			frameDescriptorSets.resize(commonLayouts.size());
 			if (vkAllocateDescriptorSets(device.device, &commonAllocInfo,
-			                             &commonDescriptorSets[i]) != VK_SUCCESS)
+			                             frameDescriptorSets.data()) != VK_SUCCESS)
 				throw std::runtime_error(LOCATION "failed to allocate descriptor sets!");
+		}
+
+		if (vkAllocateDescriptorSets(device.device, &allocInfo, descriptorSets.data()) !=
+		    VK_SUCCESS)
+			throw std::runtime_error(LOCATION "failed to allocate descriptor sets!");
 
-			if (vkAllocateDescriptorSets(device.device, &allocInfo, descriptorSets[i].data()) !=
-			    VK_SUCCESS)
+		std::array<VkDescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> upscaleLayouts;
+		upscaleLayouts.fill(upscaleDescriptorSetLayout);
+
+		VkDescriptorSetAllocateInfo upscaleAllocInfo = {};
+		upscaleAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		upscaleAllocInfo.descriptorPool = descriptorPool;
+		upscaleAllocInfo.descriptorSetCount = MAX_FRAMES_IN_FLIGHT;
+		upscaleAllocInfo.pSetLayouts = upscaleLayouts.data();
+
+		for (auto& module : modules)
+			if (module.scaled() &&
+			    vkAllocateDescriptorSets(device.device, &upscaleAllocInfo,
+			                             module.upscaleDescriptorSets.data()) != VK_SUCCESS)
 				throw std::runtime_error(LOCATION "failed to allocate descriptor sets!");
 
-			{
-				VkDescriptorBufferInfo dataBufferInfo = {};
-				dataBufferInfo.buffer = dataBuffers[i].buffer;
-				dataBufferInfo.offset = 0;
-				dataBufferInfo.range = sizeof(UniformBufferObject);
-
-				VkDescriptorImageInfo backgroundImageInfo = {};
-				backgroundImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-				backgroundImageInfo.imageView = backgroundImage.view;
-				backgroundImageInfo.sampler = backgroundImage.sampler;
-
-				std::array<VkWriteDescriptorSet, 4> descriptorWrites = {};
-				descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-				descriptorWrites[0].dstBinding = 0;
-				descriptorWrites[0].dstArrayElement = 0;
-				descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-				descriptorWrites[0].descriptorCount = 1;
-				descriptorWrites[0].pBufferInfo = &dataBufferInfo;
-
-				descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-				descriptorWrites[1].dstBinding = 1;
-				descriptorWrites[1].dstArrayElement = 0;
-				descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
-				descriptorWrites[1].descriptorCount = 1;
-				descriptorWrites[1].pTexelBufferView = &lAudioBuffers[i].view;
-
-				descriptorWrites[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-				descriptorWrites[2].dstBinding = 2;
-				descriptorWrites[2].dstArrayElement = 0;
-				descriptorWrites[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
-				descriptorWrites[2].descriptorCount = 1;
-				descriptorWrites[2].pTexelBufferView = &rAudioBuffers[i].view;
-
-				descriptorWrites[3].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-				descriptorWrites[3].dstBinding = 3;
-				descriptorWrites[3].dstArrayElement = 0;
-				descriptorWrites[3].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-				descriptorWrites[3].descriptorCount = 1;
-				descriptorWrites[3].pImageInfo = &backgroundImageInfo;
-
-				descriptorWrites[0].dstSet = commonDescriptorSets[i];
-				descriptorWrites[1].dstSet = commonDescriptorSets[i];
-				descriptorWrites[2].dstSet = commonDescriptorSets[i];
-				descriptorWrites[3].dstSet = commonDescriptorSets[i];
-
-				vkUpdateDescriptorSets(device.device,
-				                       static_cast<uint32_t>(descriptorWrites.size()),
-				                       descriptorWrites.data(), 0, nullptr);
+		// the common descriptor sets point at the slice of their frame in the upload buffer, the
+		// uniform buffer object of each module is selected by a dynamic offset
+		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+			for (size_t spectra = 0; spectra < commonDescriptorSets[i].size(); ++spectra)
+				updateCommonDescriptorSet(i, spectra);
+		}
+
+		createSmoothingDescriptorSets();
+		if (settings.gpuAnalysis) createAnalysisDescriptorSets();
+
+		// module resources never change, so a single set per module is shared by every frame
+		for (size_t module = 0; module < modules.size(); ++module) {
+			const size_t resourceCount = modules[module].images.size();
+
+			std::vector<VkDescriptorImageInfo> moduleImageInfos{resourceCount};
+			std::vector<VkWriteDescriptorSet> descriptorWrites{resourceCount};
+
+			for (size_t image = 0; image < modules[module].images.size(); ++image) {
+				moduleImageInfos[image].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+				moduleImageInfos[image].imageView = modules[module].images[image].rsrc.view;
+				moduleImageInfos[image].sampler = modules[module].images[image].rsrc.sampler;
+
+				descriptorWrites[image].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				descriptorWrites[image].dstBinding = modules[module].images[image].id;
+				descriptorWrites[image].dstArrayElement = 0;
+				descriptorWrites[image].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+				descriptorWrites[image].descriptorCount = 1;
+				descriptorWrites[image].pImageInfo = &moduleImageInfos[image];
+				descriptorWrites[image].dstSet = descriptorSets[module];
+			}
+
+			vkUpdateDescriptorSets(device.device, static_cast<uint32_t>(descriptorWrites.size()),
+			                       descriptorWrites.data(), 0, nullptr);
+		}
+
+		updateUpscaleDescriptorSets();
+	}
+
+	/**
+	 * Points the common descriptor set of a frame at its uniform buffer objects and spectra,
+	 * spectra 0 being the unsmoothed audio of the upload buffer and the others the outputs of
+	 * the smoothing passes
+	 */
+	void updateCommonDescriptorSet(size_t frame, size_t spectra) {
+		VkDescriptorBufferInfo dataBufferInfo = {};
+		dataBufferInfo.buffer = shaderAudioBuffer().buffer;
+		dataBufferInfo.offset = frame * uploadSliceSize;
+		dataBufferInfo.range = sizeof(UniformBufferObject);
+
+		VkDescriptorImageInfo backgroundImageInfo = {};
+		backgroundImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		backgroundImageInfo.imageView = backgroundImage.view;
+		backgroundImageInfo.sampler = backgroundImage.sampler;
+
+		std::array<VkBufferView, 2> audioViews;
+		for (size_t channel = 0; channel < 2; ++channel)
+			audioViews[channel] =
+			    spectra ? smoothedBuffer.views[smoothedIndex(frame, spectra - 1, channel)]
+			            : shaderAudioBuffer().views[2 * frame + channel];
+
+		std::vector<VkWriteDescriptorSet> descriptorWrites(useSpectrumImages ? 6 : 4);
+		descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[0].dstBinding = 0;
+		descriptorWrites[0].dstArrayElement = 0;
+		descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		descriptorWrites[0].descriptorCount = 1;
+		descriptorWrites[0].pBufferInfo = &dataBufferInfo;
+
+		descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[1].dstBinding = 1;
+		descriptorWrites[1].dstArrayElement = 0;
+		descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+		descriptorWrites[1].descriptorCount = 1;
+		descriptorWrites[1].pTexelBufferView = &audioViews[0];
+
+		descriptorWrites[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[2].dstBinding = 2;
+		descriptorWrites[2].dstArrayElement = 0;
+		descriptorWrites[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+		descriptorWrites[2].descriptorCount = 1;
+		descriptorWrites[2].pTexelBufferView = &audioViews[1];
+
+		descriptorWrites[3].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[3].dstBinding = 3;
+		descriptorWrites[3].dstArrayElement = 0;
+		descriptorWrites[3].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		descriptorWrites[3].descriptorCount = 1;
+		descriptorWrites[3].pImageInfo = &backgroundImageInfo;
+
+		std::array<VkDescriptorImageInfo, 2> spectrumImageInfos;
+		if (useSpectrumImages) {
+			for (size_t channel = 0; channel < 2; ++channel) {
+				spectrumImageInfos[channel].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+				spectrumImageInfos[channel].imageView =
+				    spectrumImages[spectrumImageIndex(frame, spectra, channel)].view;
+				spectrumImageInfos[channel].sampler = spectrumSampler;
+
+				auto& descriptorWrite = descriptorWrites[4 + channel];
+				descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				descriptorWrite.dstBinding = static_cast<uint32_t>(4 + channel);
+				descriptorWrite.dstArrayElement = 0;
+				descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+				descriptorWrite.descriptorCount = 1;
+				descriptorWrite.pImageInfo = &spectrumImageInfos[channel];
+			}
+		}
+
+		for (auto& descriptorWrite : descriptorWrites)
+			descriptorWrite.dstSet = commonDescriptorSets[frame][spectra];
+
+		vkUpdateDescriptorSets(device.device, static_cast<uint32_t>(descriptorWrites.size()),
+		                       descriptorWrites.data(), 0, nullptr);
+	}
+
+	/**
+	 * Points the descriptor sets of the gpu analysis at the slice and intermediate results of
+	 * their frame
+	 */
+	void createAnalysisDescriptorSets() {
+		std::array<VkDescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> layouts;
+		layouts.fill(analysisDescriptorSetLayout);
+
+		VkDescriptorSetAllocateInfo allocInfo = {};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = descriptorPool;
+		allocInfo.descriptorSetCount = MAX_FRAMES_IN_FLIGHT;
+		allocInfo.pSetLayouts = layouts.data();
+
+		if (vkAllocateDescriptorSets(device.device, &allocInfo, analysisDescriptorSets.data()) !=
+		    VK_SUCCESS)
+			throw std::runtime_error(LOCATION "failed to allocate descriptor sets!");
+
+		for (size_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
+			std::array<VkDescriptorBufferInfo, 2> bufferInfos = {};
+			bufferInfos[0].buffer = shaderAudioBuffer().buffer;
+			bufferInfos[0].offset = frame * uploadSliceSize;
+			bufferInfos[0].range = uploadSliceSize;
+			bufferInfos[1].buffer = analysisBuffer.buffer;
+			bufferInfos[1].offset = frame * analysisStride;
+			bufferInfos[1].range = analysisStride;
+
+			std::array<VkWriteDescriptorSet, 2> descriptorWrites = {};
+			for (uint32_t binding = 0; binding < descriptorWrites.size(); ++binding) {
+				descriptorWrites[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				descriptorWrites[binding].dstSet = analysisDescriptorSets[frame];
+				descriptorWrites[binding].dstBinding = binding;
+				descriptorWrites[binding].dstArrayElement = 0;
+				descriptorWrites[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+				descriptorWrites[binding].descriptorCount = 1;
+				descriptorWrites[binding].pBufferInfo = &bufferInfos[binding];
 			}
 
-			for (size_t module = 0; module < modules.size(); ++module) {
-				const size_t resourceCount = modules[module].images.size();
-
-				std::vector<VkDescriptorImageInfo> moduleImageInfos{resourceCount};
-				std::vector<VkWriteDescriptorSet> descriptorWrites{resourceCount};
-
-				for (size_t image = 0; image < modules[module].images.size(); ++image) {
-					moduleImageInfos[image].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-					moduleImageInfos[image].imageView = modules[module].images[image].rsrc.view;
-					moduleImageInfos[image].sampler = modules[module].images[image].rsrc.sampler;
-
-					descriptorWrites[image].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-					descriptorWrites[image].dstBinding = modules[module].images[image].id;
-					descriptorWrites[image].dstArrayElement = 0;
-					descriptorWrites[image].descriptorType =
-					    VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-					descriptorWrites[image].descriptorCount = 1;
-					descriptorWrites[image].pImageInfo = &moduleImageInfos[image];
-					descriptorWrites[image].dstSet = descriptorSets[i][module];
+			vkUpdateDescriptorSets(device.device, static_cast<uint32_t>(descriptorWrites.size()),
+			                       descriptorWrites.data(), 0, nullptr);
+		}
+	}
+
+	/**
+	 * Points the descriptor sets of every smoothing pass at the unsmoothed audio of their frame
+	 * and the part of the smoothed buffer they write to
+	 */
+	void createSmoothingDescriptorSets() {
+		if (smoothingPasses.empty()) return;
+
+		const std::vector<VkDescriptorSetLayout> layouts(2 * smoothingPasses.size(),
+		                                                 smoothingDescriptorSetLayout);
+
+		VkDescriptorSetAllocateInfo allocInfo = {};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = descriptorPool;
+		allocInfo.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+		allocInfo.pSetLayouts = layouts.data();
+
+		for (size_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
+			smoothingDescriptorSets[frame].resize(layouts.size());
+			if (vkAllocateDescriptorSets(device.device, &allocInfo,
+			                             smoothingDescriptorSets[frame].data()) != VK_SUCCESS)
+				throw std::runtime_error(LOCATION "failed to allocate descriptor sets!");
+
+			for (size_t pass = 0; pass < smoothingPasses.size(); ++pass) {
+				for (size_t channel = 0; channel < 2; ++channel) {
+					VkDescriptorBufferInfo smoothedBufferInfo = {};
+					smoothedBufferInfo.buffer = smoothedBuffer.buffer;
+					smoothedBufferInfo.offset =
+					    smoothedIndex(frame, pass, channel) * smoothedStride;
+					smoothedBufferInfo.range = settings.audioSize * sizeof(float);
+
+					std::array<VkWriteDescriptorSet, 2> descriptorWrites = {};
+					descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+					descriptorWrites[0].dstBinding = 0;
+					descriptorWrites[0].dstArrayElement = 0;
+					descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+					descriptorWrites[0].descriptorCount = 1;
+					descriptorWrites[0].pTexelBufferView =
+					    &shaderAudioBuffer().views[2 * frame + channel];
+
+					descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+					descriptorWrites[1].dstBinding = 1;
+					descriptorWrites[1].dstArrayElement = 0;
+					descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+					descriptorWrites[1].descriptorCount = 1;
+					descriptorWrites[1].pBufferInfo = &smoothedBufferInfo;
+
+					for (auto& descriptorWrite : descriptorWrites)
+						descriptorWrite.dstSet = smoothingDescriptorSets[frame][2 * pass + channel];
+
+					vkUpdateDescriptorSets(device.device,
+					                       static_cast<uint32_t>(descriptorWrites.size()),
+					                       descriptorWrites.data(), 0, nullptr);
 				}
+			}
+		}
+	}
 
-				vkUpdateDescriptorSets(device.device,
-				                       static_cast<uint32_t>(descriptorWrites.size()),
-				                       descriptorWrites.data(), 0, nullptr);
+	/**
+	 * Points the upscale descriptor sets at the images of the scaled modules, which are
+	 * recreated along with the swap chain
+	 */
+	void updateUpscaleDescriptorSets() {
+		for (auto& module : modules) {
+			if (!module.scaled()) continue;
+
+			for (size_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
+				VkDescriptorImageInfo imageInfo = {};
+				imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+				imageInfo.imageView = module.scaledImages[frame].view;
+				imageInfo.sampler = module.scaledImages[frame].sampler;
+
+				VkWriteDescriptorSet descriptorWrite = {};
+				descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				descriptorWrite.dstSet = module.upscaleDescriptorSets[frame];
+				descriptorWrite.dstBinding = 0;
+				descriptorWrite.dstArrayElement = 0;
+				descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+				descriptorWrite.descriptorCount = 1;
+				descriptorWrite.pImageInfo = &imageInfo;
+
+				vkUpdateDescriptorSets(device.device, 1, &descriptorWrite, 0, nullptr);
 			}
 		}
 	}
@@ -1789,11 +3843,31 @@ private:
 
 		if (config.moduleName) module.moduleName = config.moduleName.value();
 		if (config.vertexCount) module.vertexCount = config.vertexCount.value();
-
-		module.specializationConstants.data.reserve(5 + config.params.size());
-		module.specializationConstants.data.resize(5);
-		module.specializationConstants.specializationInfo.reserve(5 + config.params.size());
-		for (uint32_t offset = 0; offset < 5; ++offset) {
+		module.instanceSize = config.instanceSize;
+		module.bounds = config.bounds;
+		if (config.bounds) module.parameters = parameterValues(config.params);
+		module.bands = config.bands;
+		module.fixedRenderScale = config.renderScale;
+		module.fixedSmoothingLevel = config.smoothingLevel;
+
+		if (config.smoothing == "mcat")
+			module.smoothingKernel = SmoothingKernel::mcat;
+		else if (config.smoothing == "shader")
+			module.smoothingKernel = SmoothingKernel::shader;
+		else if (config.smoothing && config.smoothing != "gaussian")
+			std::cerr << LOCATION "smoothing of module " << configFilePath.parent_path()
+			          << " set to an invalid value!\n";
+
+		if (config.spectrum == "image")
+			module.spectrumImages = true;
+		else if (config.spectrum && config.spectrum != "buffer")
+			std::cerr << LOCATION "spectrum of module " << configFilePath.parent_path()
+			          << " set to an invalid value!\n";
+
+		module.specializationConstants.data.reserve(6 + config.params.size());
+		module.specializationConstants.data.resize(6);
+		module.specializationConstants.specializationInfo.reserve(6 + config.params.size());
+		for (uint32_t offset = 0; offset < 6; ++offset) {
 			VkSpecializationMapEntry mapEntry = {};
 			mapEntry.constantID = offset;
 			mapEntry.offset = offset * sizeof(SpecializationConstant);
@@ -1830,6 +3904,37 @@ Renderer& Renderer::operator=(Renderer&& other) noexcept {
 	return *this;
 }
 
-bool Renderer::drawFrame(const AudioData& audioData) { return rendererImpl->drawFrame(audioData); }
+bool Renderer::drawFrame(const AudioData& audioData,
+                         std::optional<std::chrono::milliseconds> time) {
+	return rendererImpl->drawFrame(audioData, time);
+}
+
+void Renderer::flush() { rendererImpl->flush(); }
+
+size_t Renderer::bands() const { return rendererImpl->bands(); }
+
+bool Renderer::gpuAnalysis() const { return rendererImpl->gpuAnalysis(); }
+
+void Renderer::analyse(AudioData& audioData) { rendererImpl->analyse(audioData); }
+
+void Renderer::disableGpuAnalysis() { rendererImpl->disableGpuAnalysis(); }
+
+bool Renderer::needsRedraw(bool animate) const { return rendererImpl->needsRedraw(animate); }
+
+bool Renderer::waitEvents(std::chrono::milliseconds timeout) {
+	return rendererImpl->waitEvents(timeout);
+}
+
+void Renderer::wake() { rendererImpl->wake(); }
+
+std::vector<Renderer::GpuTime> Renderer::gpuTimes() const { return rendererImpl->gpuTimes(); }
+
+float Renderer::gpuFrameTime() const { return rendererImpl->gpuFrameTime(); }
+
+float Renderer::cpuFrameTime() const { return rendererImpl->cpuFrameTime(); }
+
+void Renderer::setQuality(float renderScale, float smoothingLevel) {
+	rendererImpl->setQuality(renderScale, smoothingLevel);
+}
 
 Renderer::~Renderer() { delete rendererImpl; }
@@ -186,6 +186,33 @@ std::vector<std::filesystem::path> getConfigLocations() {
 	return configLocations;
 }
 
+std::filesystem::path getCacheLocation() {
+	std::filesystem::path cacheLocation;
+#ifdef LINUX
+	if (const char* cacheHome = std::getenv("XDG_CACHE_HOME"); cacheHome && *cacheHome) {
+		cacheLocation = cacheHome;
+	} else {
+		if (const char* home = std::getenv("HOME")) cacheLocation = home;
+		if (cacheLocation.empty()) cacheLocation = getpwuid(geteuid())->pw_dir;
+		cacheLocation /= ".cache";
+	}
+	cacheLocation /= "vkav";
+#elif defined(MACOS)
+	if (const char* home = std::getenv("HOME")) cacheLocation = home;
+	if (cacheLocation.empty()) cacheLocation = getpwuid(geteuid())->pw_dir;
+	cacheLocation /= "Library/Caches/vkav";
+#elif defined(WINDOWS)
+	const char* path;
+	SHGetKnownFolderPath(FOLDERID_LocalAppData, KF_FLAG_DEFAULT, NULL, path);
+	cacheLocation = path;
+	cacheLocation /= "vkav";
+	CoTaskMemFree(path);
+#else
+#endif
+
+	return cacheLocation;
+}
+
 std::unordered_map<std::string, std::vector<std::filesystem::path>> getModules() {
 	auto configLocations = getConfigLocations();
 	std::unordered_map<std::string, std::vector<std::filesystem::path>> modules;
@@ -0,0 +1,169 @@
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "Spirv.hpp"
+
+#ifdef NDEBUG
+	#define LOCATION
+#else
+	#define STR_HELPER(x) #x
+	#define STR(x) STR_HELPER(x)
+	#define LOCATION __FILE__ ":" STR(__LINE__) ": "
+#endif
+
+namespace {
+	constexpr uint32_t magicNumber = 0x07230203;
+	constexpr size_t headerSize = 5;
+
+	enum Op : uint16_t {
+		OpTypeStruct = 30,
+		OpTypePointer = 32,
+		OpConstant = 43,
+		OpVariable = 59,
+		OpLoad = 61,
+		OpAccessChain = 65,
+		OpInBoundsAccessChain = 66,
+		OpDecorate = 71,
+	};
+
+	enum Decoration : uint32_t {
+		DecorationSpecId = 1,
+		DecorationBinding = 33,
+		DecorationDescriptorSet = 34,
+	};
+
+	constexpr uint32_t StorageClassUniform = 2;
+
+	std::vector<uint32_t> words(const std::vector<char>& code) {
+		if (code.size() % 4 || code.size() < 4 * headerSize)
+			throw std::invalid_argument(LOCATION "invalid spir-v size!");
+
+		std::vector<uint32_t> words(code.size() / 4);
+		std::memcpy(words.data(), code.data(), code.size());
+		if (words[0] != magicNumber) throw std::invalid_argument(LOCATION "invalid spir-v!");
+		return words;
+	}
+
+	/**
+	 * Calls function with the opcode and operands of each instruction
+	 */
+	template <class Function>
+	void forEachInstruction(const std::vector<uint32_t>& words, Function function) {
+		for (size_t i = headerSize; i < words.size();) {
+			const uint16_t opcode = words[i] & 0xFFFF;
+			const uint16_t wordCount = words[i] >> 16;
+			if (wordCount == 0 || i + wordCount > words.size())
+				throw std::invalid_argument(LOCATION "invalid spir-v instruction!");
+
+			function(opcode, words.data() + i + 1, wordCount - 1u);
+			i += wordCount;
+		}
+	}
+
+	struct UniformBlock {
+		uint32_t variable = 0;
+		uint32_t memberCount = 0;
+	};
+
+	/**
+	 * Finds the variable of the uniform block at the given set and binding, variable is 0 if the
+	 * shader does not use it
+	 */
+	UniformBlock findUniformBlock(const std::vector<uint32_t>& words, uint32_t set,
+	                              uint32_t binding) {
+		struct Binding {
+			bool hasSet = false;
+			bool hasBinding = false;
+			uint32_t set;
+			uint32_t binding;
+		};
+		std::unordered_map<uint32_t, Binding> bindings;
+		std::unordered_map<uint32_t, uint32_t> pointerTypes;
+		std::unordered_map<uint32_t, uint32_t> structMemberCounts;
+		std::vector<std::pair<uint32_t, uint32_t>> uniformVariables;
+
+		forEachInstruction(words, [&](uint16_t opcode, const uint32_t* operands, size_t count) {
+			switch (opcode) {
+				case OpDecorate:
+					if (count < 3) break;
+					if (operands[1] == DecorationDescriptorSet) {
+						bindings[operands[0]].hasSet = true;
+						bindings[operands[0]].set = operands[2];
+					} else if (operands[1] == DecorationBinding) {
+						bindings[operands[0]].hasBinding = true;
+						bindings[operands[0]].binding = operands[2];
+					}
+					break;
+				case OpTypePointer:
+					if (count >= 3) pointerTypes[operands[0]] = operands[2];
+					break;
+				case OpTypeStruct:
+					if (count >= 1) structMemberCounts[operands[0]] = count - 1;
+					break;
+				case OpVariable:
+					if (count >= 3 && operands[2] == StorageClassUniform)
+						uniformVariables.emplace_back(operands[1], operands[0]);
+					break;
+			}
+		});
+
+		for (auto [variable, type] : uniformVariables) {
+			const auto it = bindings.find(variable);
+			if (it == bindings.end() || !it->second.hasSet || !it->second.hasBinding) continue;
+			if (it->second.set != set || it->second.binding != binding) continue;
+
+			if (const auto pointee = pointerTypes.find(type); pointee != pointerTypes.end())
+				if (const auto block = structMemberCounts.find(pointee->second);
+				    block != structMemberCounts.end())
+					return {variable, block->second};
+		}
+		return {};
+	}
+}  // namespace
+
+uint32_t uniformBlockMemberCount(const std::vector<char>& code, uint32_t set, uint32_t binding) {
+	return findUniformBlock(words(code), set, binding).memberCount;
+}
+
+bool uniformBlockMemberUsed(const std::vector<char>& code, uint32_t set, uint32_t binding,
+                            uint32_t member) {
+	const std::vector<uint32_t> instructions = words(code);
+	const uint32_t variable = findUniformBlock(instructions, set, binding).variable;
+	if (variable == 0) return false;
+
+	std::unordered_map<uint32_t, uint32_t> constants;
+	bool used = false;
+	forEachInstruction(instructions, [&](uint16_t opcode, const uint32_t* operands,
+	                                     size_t count) {
+		switch (opcode) {
+			case OpConstant:
+				if (count >= 3) constants[operands[1]] = operands[2];
+				break;
+			// members are read through access chains, loading the whole block reads all of them
+			case OpLoad:
+				if (count >= 3 && operands[2] == variable) used = true;
+				break;
+			case OpAccessChain:
+			case OpInBoundsAccessChain:
+				if (count >= 4 && operands[2] == variable) {
+					const auto index = constants.find(operands[3]);
+					if (index == constants.end() || index->second == member) used = true;
+				}
+				break;
+		}
+	});
+	return used;
+}
+
+bool hasSpecializationConstant(const std::vector<char>& code, uint32_t id) {
+	bool found = false;
+	forEachInstruction(words(code), [&](uint16_t opcode, const uint32_t* operands, size_t count) {
+		if (opcode == OpDecorate && count >= 3 && operands[1] == DecorationSpecId &&
+		    operands[2] == id)
+			found = true;
+	});
+	return found;
+}
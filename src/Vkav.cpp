@@ -1,11 +1,16 @@
 // C++ standard libraries
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
 #include <cstdlib>
+#include <exception>
 #include <filesystem>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <optional>
+#include <random>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -14,11 +19,16 @@
 #include <utility>
 
 #include "Audio.hpp"
+#include "AudioFile.hpp"
 #include "Calculate.hpp"
 #include "Data.hpp"
+#include "FrameWriter.hpp"
+#include "Governor.hpp"
 #include "Process.hpp"
 #include "Render.hpp"
 #include "Settings.hpp"
+#include "SilenceDetector.hpp"
+#include "TripleBuffer.hpp"
 #include "Version.hpp"
 
 #define STR_HELPER(x) #x
@@ -56,6 +66,10 @@ namespace {
 	    "-a, --amplitude=AMPLITUDE             Multiplies audio with AMPLITUDE.\n"
 	    "    --install-config                  Installs config files to a user\n"
 	    "    --list-modules                    Output the list of available modules and exit\n"
+	    "    --render=AUDIO_FILE               Renders a WAV file offscreen as fast as\n"
+	    "                                        possible instead of visualising live audio.\n"
+	    "    --out=OUTPUT                      Where rendered frames are written, a directory\n"
+	    "                                        for PNGs, a .y4m file or - for y4m on stdout.\n"
 	    "-h, --help                            Display this help and exit.\n"
 	    "-V, --version                         Output version information and exit.\n"
 	    "                                        specific config directory.\n"
@@ -66,6 +80,30 @@ namespace {
 
 #define WARN_UNDEFINED(name) std::clog << #name << " not defined!" << std::endl;
 
+	/**
+	 * Multipliers applied to the configured quality at each level of the governor, every level
+	 * lowers one setting at a time starting with the cheapest to give up
+	 */
+	struct QualityLevel {
+		float renderScale;
+		float smoothingLevel;
+		// the fft size is the buffer size divided by this
+		size_t fftDivisor;
+		// 0 keeps the configured fps limit
+		size_t fpsCap;
+	};
+
+	static constexpr QualityLevel qualityLevels[] = {
+	    {1.f, 1.f, 1, 0},     {0.75f, 1.f, 1, 0},   {0.75f, 0.5f, 1, 0},  {0.75f, 0.5f, 2, 0},
+	    {0.5f, 0.5f, 2, 0},   {0.5f, 0.25f, 2, 0},  {0.5f, 0.25f, 4, 0},  {0.5f, 0.25f, 4, 30}};
+
+	// smallest fft size the governor lowers the analysis to
+	static constexpr size_t minFftSize = 256;
+
+	// largest difference between the gpu and cpu analyses relative to the loudest bin, the float
+	// rounding of either is orders of magnitude below it
+	static constexpr float maxGpuAnalysisError = 1e-3f;
+
 	class Vkav {
 	public:
 		Vkav(int argc, const char* argv[]) {
@@ -127,10 +165,38 @@ namespace {
 			AudioSampler::Settings audioSettings = {};
 			Renderer::Settings renderSettings = {};
 			renderSettings.moduleLocations = configLocations;
+			if (auto cacheLocation = getCacheLocation(); !cacheLocation.empty())
+				renderSettings.pipelineCachePath = cacheLocation / "pipelineCache";
 			Process::Settings processSettings = {};
 
 			fillStructs(cmdLineArgs, audioSettings, renderSettings, processSettings);
 
+			if (auto it = cmdLineArgs.find("render"); it != cmdLineArgs.end()) {
+				const auto out = cmdLineArgs.find("out");
+				if (it->second.empty() || out == cmdLineArgs.end() || out->second.empty())
+					throw std::invalid_argument(LOCATION
+					                            "--render requires an audio file and --out!");
+
+				renderFps = 60;
+				if (auto fps = cmdLineArgs.find("renderFps"); fps != cmdLineArgs.end())
+					renderFps = calculate<size_t>(fps->second);
+				else
+					WARN_UNDEFINED(renderFps);
+				if (renderFps == 0)
+					throw std::invalid_argument(LOCATION "renderFps must not be 0!");
+
+				std::clog << "Reading " << it->second << std::endl;
+				renderAudio = AudioFile(parseAsString(it->second))
+				                  .convert(audioSettings.sampleRate, audioSettings.channels);
+
+				frameWriter = FrameWriter(parseAsString(out->second), renderSettings.window.width,
+				                          renderSettings.window.height, renderFps);
+				renderSettings.headless = true;
+				renderSettings.frameCallback = [this](const unsigned char* pixels) {
+					frameWriter.write(pixels);
+				};
+			}
+
 			fpsLimit = 0;
 			if (auto it = cmdLineArgs.find("fpsLimit"); it != cmdLineArgs.end())
 				fpsLimit = calculate<size_t>(it->second);
@@ -138,13 +204,78 @@ namespace {
 				WARN_UNDEFINED(fpsLimit);
 			renderSettings.vsync = (fpsLimit == 0);
 
-			std::clog << "Initialising audio" << std::endl;
-			audioSampler = AudioSampler(audioSettings);
+			float frameBudget = 0.f;
+			if (auto it = cmdLineArgs.find("frameBudget"); it != cmdLineArgs.end())
+				frameBudget = calculate<float>(it->second);
+			else
+				WARN_UNDEFINED(frameBudget);
+			if (frameBudget < 0.f) {
+				std::cerr << LOCATION "Frame budget set to an invalid value!\n";
+				frameBudget = 0.f;
+			}
+			// the governor needs the gpu time of every frame, rendering offline has no budget
+			if (frameBudget > 0.f && renderFps == 0) {
+				Governor::Settings governorSettings = {};
+				governorSettings.budget = frameBudget;
+				governorSettings.maxLevel = std::size(qualityLevels) - 1;
+				governor = Governor(governorSettings);
+				useGovernor = true;
+				renderSettings.profile = true;
+			}
+			channels = audioSettings.channels;
+			bufferSize = audioSettings.bufferSize;
+			fftSize = bufferSize;
+			baseRenderScale = renderSettings.renderScale;
+			baseSmoothingLevel = renderSettings.smoothingLevel;
+			fullAnalysis = (processSettings.analysis == Process::Analysis::full);
+
+			float idleThreshold = 0.f;
+			if (auto it = cmdLineArgs.find("idleThreshold"); it != cmdLineArgs.end())
+				idleThreshold = calculate<float>(it->second);
+			else
+				WARN_UNDEFINED(idleThreshold);
+
+			// the gpu analysis leaves only the samples to measure the volume on the cpu
+			float idleSampleThreshold = 0.f;
+			if (auto it = cmdLineArgs.find("idleSampleThreshold"); it != cmdLineArgs.end())
+				idleSampleThreshold = calculate<float>(it->second);
+			else
+				WARN_UNDEFINED(idleSampleThreshold);
+
+			float idleTimeout = 0.f;
+			if (auto it = cmdLineArgs.find("idleTimeout"); it != cmdLineArgs.end())
+				idleTimeout = calculate<float>(it->second);
+			else
+				WARN_UNDEFINED(idleTimeout);
+
+			sampleRate = audioSettings.sampleRate;
+
+			idleFpsLimit = 0;
+			if (auto it = cmdLineArgs.find("idleFpsLimit"); it != cmdLineArgs.end())
+				idleFpsLimit = calculate<size_t>(it->second);
+			else
+				WARN_UNDEFINED(idleFpsLimit);
+
+			if (renderFps == 0) {
+				std::clog << "Initialising audio" << std::endl;
+				audioSampler = AudioSampler(audioSettings);
+			}
 			std::clog << "Initialising renderer" << std::endl;
 			renderer = Renderer(renderSettings);
+			processSettings.bands = renderer.bands();
 			process = Process(processSettings);
 
-			audioData.allocate(audioSettings.channels, audioSettings.bufferSize);
+			audioData.forEach([&](AudioData& data) {
+				data.allocate(audioSettings.channels, audioSettings.bufferSize);
+			});
+
+			if (renderer.gpuAnalysis()) gpuAnalysis = checkGpuAnalysis(renderSettings.audioSize);
+			// the fft size of the gpu analysis is fixed
+			if (gpuAnalysis) fullAnalysis = false;
+
+			silenceDetector =
+			    SilenceDetector(gpuAnalysis ? idleSampleThreshold : idleThreshold,
+			                    SilenceDetector::Duration(idleTimeout));
 
 			auto initEnd = std::chrono::high_resolution_clock::now();
 			std::clog << "Initialisation took: "
@@ -153,47 +284,314 @@ namespace {
 			          << " milliseconds" << std::endl;
 		}
 
+		~Vkav() { stopDsp(); }
+
 		void run() {
+			if (renderFps) {
+				render();
+				return;
+			}
+
 			int numFrames = 0;
-			const std::chrono::microseconds targetFrameTime{(fpsLimit ? 1000000 / fpsLimit : 0)};
+			std::chrono::microseconds targetFrameTime{(fpsLimit ? 1000000 / fpsLimit : 0)};
+			const std::chrono::microseconds idleFrameTime{
+			    (idleFpsLimit ? 1000000 / idleFpsLimit : 0)};
 			auto lastFrame = std::chrono::steady_clock::now();
 			auto lastUpdate = std::chrono::steady_clock::now();
-
-			while (audioSampler.running()) {
-				if (audioSampler.modified()) {
-					audioSampler.copyData(audioData);
-					process.processSignal(audioData);
+			auto lastIteration = std::chrono::steady_clock::now();
+			std::chrono::steady_clock::duration idleTime{0}, activeTime{0};
+
+			dspRunning = true;
+			dspThread = std::thread([&]() {
+				try {
+					runDsp();
+				} catch (const std::exception& e) {
+					dspExceptionPtr = std::current_exception();
 				}
+				dspRunning = false;
+			});
 
-				if (fpsLimit) std::this_thread::sleep_until(lastFrame + targetFrameTime);
-				if (!renderer.drawFrame(audioData)) break;
-
-				lastFrame = std::chrono::steady_clock::now();
-				++numFrames;
+			while (audioSampler.running() && dspRunning) {
+				const bool newAudio = audioData.update();
+				const bool isIdle = idle;
 
 				auto currentTime = std::chrono::steady_clock::now();
+				(isIdle ? idleTime : activeTime) += currentTime - lastIteration;
+				lastIteration = currentTime;
+
 				if (std::chrono::duration_cast<std::chrono::seconds>(currentTime - lastUpdate)
 				        .count() >= 1) {
-					std::clog << "FPS: " << std::setw(3) << std::right << numFrames
-					          << " | UPS: " << std::setw(3) << std::right << audioSampler.ups()
-					          << std::endl;
+					using std::chrono::seconds;
+					// formatted separately so that the manipulators don't stick to std::clog
+					std::ostringstream line;
+					line << "FPS: " << std::setw(3) << std::right << numFrames
+					     << " | UPS: " << std::setw(3) << std::right << audioSampler.ups()
+					     << " | Idle: " << std::setw(6) << std::right
+					     << std::chrono::duration_cast<seconds>(idleTime).count()
+					     << "s | Active: " << std::setw(6) << std::right
+					     << std::chrono::duration_cast<seconds>(activeTime).count() << 's';
+					// min/avg/p99 gpu time of each module in milliseconds
+					for (const auto& time : renderer.gpuTimes())
+						line << " | " << time.name << ": " << std::fixed << std::setprecision(2)
+						     << time.min << '/' << time.average << '/' << time.p99 << "ms";
+					std::clog << line.str() << std::endl;
 					numFrames = 0;
 					lastUpdate = currentTime;
 				}
+
+				// skip frames that would be identical to the previous one, while idle the audio
+				// is ignored and only the idle fps limit keeps animated modules going
+				std::chrono::steady_clock::duration timeout = waitTimeout;
+				bool draw;
+				if (isIdle) {
+					draw = renderer.needsRedraw(false);
+					if (idleFpsLimit && renderer.needsRedraw()) {
+						const auto nextFrame = lastFrame + idleFrameTime;
+						draw = draw || currentTime >= nextFrame;
+						timeout = std::min(timeout, nextFrame - currentTime);
+					}
+				} else {
+					draw = newAudio || renderer.needsRedraw();
+				}
+
+				if (!draw) {
+					// glfw requires a positive timeout
+					timeout = std::max(timeout, std::chrono::steady_clock::duration(
+					                                std::chrono::milliseconds(1)));
+					if (!renderer.waitEvents(
+					        std::chrono::duration_cast<std::chrono::milliseconds>(timeout)))
+						break;
+					continue;
+				}
+
+				if (targetFrameTime.count() && !isIdle)
+					std::this_thread::sleep_until(lastFrame + targetFrameTime);
+				if (!renderer.drawFrame(audioData.front())) break;
+
+				lastFrame = std::chrono::steady_clock::now();
+				++numFrames;
+
+				// the slowest of the processing, the render thread and the gpu limits the frame
+				// rate, as they run in parallel, idle frames say nothing about the cost of the
+				// audio being drawn
+				if (useGovernor && !isIdle &&
+				    governor.update(std::max({dspTime.load(), renderer.cpuFrameTime(),
+				                              renderer.gpuFrameTime()})))
+					targetFrameTime = applyQuality(qualityLevels[governor.level()]);
 			}
 
-			// rethrow any exceptions the audio thread may have thrown
+			stopDsp();
+
+			// rethrow any exceptions the audio and processing threads may have thrown
 			audioSampler.rethrowExceptions();
+			if (dspExceptionPtr) std::rethrow_exception(dspExceptionPtr);
 		}
 
 	private:
-		AudioData audioData;
+		// spectra handed from the processing thread to the renderer
+		TripleBuffer<AudioData> audioData;
+
+		// offline rendering, enabled by a non zero renderFps
+		size_t renderFps = 0;
+		std::vector<float> renderAudio;
+		FrameWriter frameWriter;
+
+		unsigned char channels;
+		size_t bufferSize;
 
 		AudioSampler audioSampler;
 		Renderer renderer;
 		Process process;
+		// the renderer computes the spectra from the samples, the processing thread only copies
+		// them and measures their volume for the silence detector
+		bool gpuAnalysis = false;
 
 		size_t fpsLimit;
+		size_t idleFpsLimit;
+
+		// lowers the quality while the frames do not fit the frame budget
+		Governor governor;
+		bool useGovernor = false;
+		float baseRenderScale;
+		float baseSmoothingLevel;
+		bool fullAnalysis;
+		// fft size requested from the processing thread and the time it last took to process
+		std::atomic<size_t> fftSize;
+		std::atomic<float> dspTime{0.f};
+
+		// only used by the processing thread
+		SilenceDetector silenceDetector;
+		int sampleRate;
+		std::atomic<bool> idle{false};
+
+		std::thread dspThread;
+		std::atomic<bool> dspRunning{false};
+		std::exception_ptr dspExceptionPtr = nullptr;
+
+		// upper bound on how long the threads sleep before checking whether they should exit
+		static constexpr std::chrono::milliseconds waitTimeout{100};
+
+		/**
+		 * Processes audio on its own thread so that the fft does not add to the frame time
+		 */
+		void runDsp() {
+			while (dspRunning && audioSampler.running()) {
+				if (!audioSampler.waitForData(waitTimeout)) continue;
+
+				if (fullAnalysis) process.setFftSize(fftSize);
+
+				AudioData& data = audioData.back();
+				audioSampler.copyData(data);
+				const auto processStart = std::chrono::steady_clock::now();
+				if (gpuAnalysis)
+					measureSampleVolume(data);
+				else
+					process.processSignal(data);
+				const std::chrono::duration<float, std::milli> processTime =
+				    std::chrono::steady_clock::now() - processStart;
+				dspTime = processTime.count();
+				audioData.publish();
+
+				// the renderer only needs to be woken while active or when leaving idle mode
+				const bool wasIdle = idle;
+				idle = silenceDetector.update(
+				    std::max(data.lVolume, data.rVolume),
+				    SilenceDetector::Duration(static_cast<float>(data.newSamples) / sampleRate));
+				if (!idle) renderer.wake();
+				if (idle != wasIdle)
+					std::clog << (idle ? "Entering" : "Leaving") << " idle mode" << std::endl;
+			}
+		}
+
+		/**
+		 * Mean absolute value of the samples added by the last copy, which the silence detector
+		 * compares to idleSampleThreshold when the spectrum is computed on the gpu
+		 */
+		void measureSampleVolume(AudioData& data) const {
+			const size_t count = std::min(data.newSamples, bufferSize);
+			const float* samples = data.buffer + channels * (bufferSize - count);
+
+			float volumes[2] = {0.f, 0.f};
+			for (size_t n = 0; n < count; ++n)
+				for (unsigned char channel = 0; channel < channels; ++channel)
+					volumes[channel] += std::abs(samples[channels * n + channel]);
+
+			data.lVolume = count ? volumes[0] / count : 0.f;
+			data.rVolume = channels == 2 ? (count ? volumes[1] / count : 0.f) : data.lVolume;
+		}
+
+		/**
+		 * Analyses a chirp in one channel and noise in the other on the cpu and the gpu, the gpu
+		 * analysis is only used when their spectra and volumes agree
+		 */
+		bool checkGpuAnalysis(size_t audioSize) {
+			AudioData cpuData, gpuData;
+			cpuData.allocate(channels, bufferSize);
+			gpuData.allocate(channels, bufferSize);
+
+			std::mt19937 generator(bufferSize);
+			std::uniform_real_distribution<float> noise(-1.f, 1.f);
+			for (size_t n = 0; n < bufferSize; ++n) {
+				cpuData.buffer[channels * n] =
+				    std::sin(static_cast<float>(M_PI) * n * n / (2 * bufferSize));
+				if (channels == 2) cpuData.buffer[2 * n + 1] = noise(generator);
+			}
+			std::copy_n(cpuData.buffer, channels * bufferSize, gpuData.buffer);
+
+			process.processSignal(cpuData);
+			renderer.analyse(gpuData);
+
+			float peak = std::max(std::abs(cpuData.lVolume), std::abs(cpuData.rVolume));
+			float difference = std::max(std::abs(cpuData.lVolume - gpuData.lVolume),
+			                            std::abs(cpuData.rVolume - gpuData.rVolume));
+			for (size_t k = 0; k < audioSize; ++k) {
+				peak = std::max({peak, std::abs(cpuData.lBuffer[k]), std::abs(cpuData.rBuffer[k])});
+				difference =
+				    std::max({difference, std::abs(cpuData.lBuffer[k] - gpuData.lBuffer[k]),
+				              std::abs(cpuData.rBuffer[k] - gpuData.rBuffer[k])});
+			}
+
+			const float error = peak > 0.f ? difference / peak : difference;
+			std::clog << "The gpu analysis differs from the cpu by " << error << std::endl;
+			if (!(error <= maxGpuAnalysisError)) {
+				std::cerr << LOCATION "the gpu analysis differs from the cpu, analysing audio on "
+				                      "the cpu!\n";
+				renderer.disableGpuAnalysis();
+				return false;
+			}
+
+			return true;
+		}
+
+		/**
+		 * Applies the multipliers of a quality level to the configured settings, returns the time
+		 * a frame has to take to keep to the resulting fps limit
+		 */
+		std::chrono::microseconds applyQuality(const QualityLevel& level) {
+			std::clog << "Quality level " << governor.level() << std::endl;
+
+			renderer.setQuality(baseRenderScale * level.renderScale,
+			                    baseSmoothingLevel * level.smoothingLevel);
+			// the sliding analysis keeps the full size, its cost does not depend on it
+			if (fullAnalysis)
+				fftSize = std::clamp(bufferSize / level.fftDivisor,
+				                     std::min(minFftSize, bufferSize), bufferSize);
+
+			size_t limit = fpsLimit;
+			if (level.fpsCap && (limit == 0 || limit > level.fpsCap)) limit = level.fpsCap;
+			return std::chrono::microseconds{limit ? 1000000 / limit : 0};
+		}
+
+		/**
+		 * Renders the audio file at a fixed time step, every frame shows the audio up to its
+		 * presentation time, independent of how long it takes to render
+		 */
+		void render() {
+			AudioData data;
+			data.allocate(channels, bufferSize);
+
+			const uint64_t length = renderAudio.size() / channels;
+			const uint64_t frameCount = (length * renderFps + sampleRate - 1) / sampleRate;
+
+			const auto renderStart = std::chrono::steady_clock::now();
+			auto lastUpdate = renderStart;
+			uint64_t end = 0;
+			for (uint64_t frame = 0; frame < frameCount; ++frame) {
+				const uint64_t newEnd = std::min(length, frame * sampleRate / renderFps);
+				data.newSamples = newEnd - end;
+				end = newEnd;
+
+				// the audio before the start of the file is silent
+				const uint64_t begin = std::max<int64_t>(0, static_cast<int64_t>(end) - bufferSize);
+				float* const silenceEnd = data.buffer + channels * (bufferSize - (end - begin));
+				std::fill(data.buffer, silenceEnd, 0.f);
+				std::copy(renderAudio.begin() + channels * begin,
+				          renderAudio.begin() + channels * end, silenceEnd);
+
+				if (!gpuAnalysis) process.processSignal(data);
+				renderer.drawFrame(data, std::chrono::milliseconds(frame * 1000 / renderFps));
+
+				if (const auto currentTime = std::chrono::steady_clock::now();
+				    currentTime - lastUpdate >= std::chrono::seconds(1)) {
+					std::clog << "Rendered " << frame + 1 << '/' << frameCount << " frames"
+					          << std::endl;
+					lastUpdate = currentTime;
+				}
+			}
+
+			renderer.flush();
+			frameWriter.close();
+
+			const std::chrono::duration<float> renderTime =
+			    std::chrono::steady_clock::now() - renderStart;
+			std::clog << "Rendered " << frameCount << " frames in " << renderTime.count()
+			          << " seconds, " << frameCount / renderTime.count() << " fps" << std::endl;
+		}
+
+		void stopDsp() {
+			dspRunning = false;
+			if (dspThread.joinable()) dspThread.join();
+		}
 
 		static void fillStructs(const std::unordered_map<std::string, std::string>& settings,
 		                        AudioSampler::Settings& audioSettings,
@@ -323,6 +721,11 @@ namespace {
 			else
 				WARN_UNDEFINED(windowType);
 
+			if (const auto setting = settings.find("headless"); setting != settings.end())
+				renderSettings.headless = (setting->second == "true");
+			else
+				WARN_UNDEFINED(headless);
+
 			float smoothingLevel = 16.0f;
 			if (const auto setting = settings.find("smoothingLevel"); setting != settings.end()) {
 				smoothingLevel = calculate<float>(setting->second);
@@ -331,7 +734,26 @@ namespace {
 				WARN_UNDEFINED(smoothingLevel);
 			}
 
+			if (const auto setting = settings.find("renderScale"); setting != settings.end()) {
+				renderSettings.renderScale = calculate<float>(setting->second);
+				if (!(renderSettings.renderScale > 0.f && renderSettings.renderScale <= 1.f)) {
+					std::cerr << LOCATION "Render scale set to an invalid value!\n";
+					renderSettings.renderScale = 1.f;
+				}
+			} else {
+				WARN_UNDEFINED(renderScale);
+			}
+
 			renderSettings.audioSize = (audioSettings.bufferSize / 2) * (1.f - trebleCut);
+
+			if (const auto setting = settings.find("bands"); setting != settings.end()) {
+				if (setting->second == "none")
+					renderSettings.bands = 0;
+				else if (setting->second != "auto")
+					renderSettings.bands = calculate<size_t>(setting->second);
+			} else {
+				WARN_UNDEFINED(bands);
+			}
 			switch (smoothingDevice) {
 				case Device::gpu:
 					smoothingLevel = 0.f;
@@ -348,14 +770,56 @@ namespace {
 				WARN_UNDEFINED(physicalDevice);
 			}
 
+			if (const auto setting = settings.find("gpuProfiling"); setting != settings.end())
+				renderSettings.profile = (setting->second == "true");
+			else
+				WARN_UNDEFINED(gpuProfiling);
+
 			processSettings.channels = audioSettings.channels;
 			processSettings.size = audioSettings.bufferSize;
+			processSettings.bins = renderSettings.audioSize;
 			processSettings.smoothingLevel = smoothingLevel;
 
+			if (const auto setting = settings.find("analysisMode"); setting != settings.end()) {
+				if (setting->second == "Full")
+					processSettings.analysis = Process::Analysis::full;
+				else if (setting->second == "Sliding")
+					processSettings.analysis = Process::Analysis::sliding;
+				else
+					std::cerr << LOCATION "Analysis mode set to an invalid value!\n";
+			} else {
+				WARN_UNDEFINED(analysisMode);
+			}
+
 			if (const auto setting = settings.find("amplitude"); setting != settings.end())
 				processSettings.amplitude = calculate<float>(setting->second);
 			else
 				WARN_UNDEFINED(amplitude);
+
+			Device processingDevice = Device::cpu;
+			if (const auto setting = settings.find("processingDevice"); setting != settings.end()) {
+				if (setting->second == "CPU")
+					processingDevice = Device::cpu;
+				else if (setting->second == "GPU")
+					processingDevice = Device::gpu;
+				else
+					std::cerr << LOCATION "Processing device set to an invalid value!\n";
+			} else {
+				WARN_UNDEFINED(processingDevice);
+			}
+
+			// the gpu only performs the full analysis, and leaves smoothing to the renderer
+			if (processingDevice == Device::gpu) {
+				if (processSettings.analysis != Process::Analysis::full)
+					std::cerr << LOCATION "the gpu analysis requires the full analysis mode, "
+					                      "analysing audio on the cpu!\n";
+				else if (smoothingDevice == Device::cpu)
+					std::cerr << LOCATION "the gpu analysis requires smoothing on the gpu, "
+					                      "analysing audio on the cpu!\n";
+				else
+					renderSettings.gpuAnalysis = {audioSettings.bufferSize, audioSettings.channels,
+					                              processSettings.amplitude};
+			}
 		}
 	};
 }  // namespace
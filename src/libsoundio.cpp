@@ -4,7 +4,6 @@
 #include <cstdlib>
 #include <exception>
 #include <iostream>
-#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -14,6 +13,7 @@
 
 #include "Audio.hpp"
 #include "Data.hpp"
+#include "RingBuffer.hpp"
 
 #ifdef NDEBUG
 	#define LOCATION
@@ -26,7 +26,6 @@
 class AudioSampler::AudioSamplerImpl {
 public:
 	std::atomic<bool> running;
-	std::atomic<bool> modified;
 	std::atomic<int> ups;
 
 	AudioSamplerImpl(const Settings& audioSettings) {
@@ -36,13 +35,10 @@ public:
 		settings.sampleRate = audioSettings.sampleRate;
 		settings.sinkName = audioSettings.sinkName;
 
-		modified = false;
 		ups = settings.sampleRate / settings.sampleSize;
 
 		pSampleBuffer = new float[settings.sampleSize];
-		ppAudioBuffer = new float*[settings.bufferSize / settings.sampleSize];
-		for (uint32_t i = 0; i < settings.bufferSize / settings.sampleSize; ++i)
-			ppAudioBuffer[i] = new float[settings.sampleSize];
+		audioBuffer.allocate(settings.bufferSize);
 
 		initSoundIo();
 		running = true;
@@ -53,20 +49,16 @@ public:
 		soundio_device_unref(device);
 		soundio_destroy(soundio);
 
-		for (uint32_t i = 0; i < settings.bufferSize / settings.sampleSize; ++i)
-			delete[] ppAudioBuffer[i];
-
-		delete[] ppAudioBuffer;
 		delete[] pSampleBuffer;
 	}
 
-	void copyData(AudioData& audioData) {
-		audioMutexLock.lock();
-		for (size_t i = 0; i < settings.bufferSize; ++i)
-			audioData.buffer[i] = ppAudioBuffer[i / settings.sampleSize][i % settings.sampleSize];
-		audioMutexLock.unlock();
+	bool modified() const { return audioBuffer.unread(); }
 
-		modified = false;
+	bool waitForData(std::chrono::milliseconds timeout) { return audioBuffer.waitUnread(timeout); }
+
+	void copyData(AudioData& audioData) {
+		audioData.newSamples =
+		    audioBuffer.readLatest(audioData.buffer, settings.bufferSize) / settings.channels;
 	}
 
 	void rethrowExceptions() {
@@ -75,13 +67,10 @@ public:
 
 private:
 	// data
-	float** ppAudioBuffer;
+	RingBuffer<float> audioBuffer;
 	float* pSampleBuffer;
 	size_t bufPos = 0;
 
-	// multithreading
-	std::mutex audioMutexLock;
-
 	// used to handle exceptions
 	std::exception_ptr exceptionPtr = nullptr;
 
@@ -224,12 +213,7 @@ private:
 	static void updateBuffers(AudioSamplerImpl* audio) {
 		static std::chrono::steady_clock::time_point lastFrame = std::chrono::steady_clock::now();
 		static int numUpdates = 0;
-		audio->audioMutexLock.lock();
-		std::swap(audio->ppAudioBuffer[0], audio->pSampleBuffer);
-		for (size_t i = 1; i * audio->settings.sampleSize < audio->settings.bufferSize; ++i)
-			std::swap(audio->ppAudioBuffer[i - 1], audio->ppAudioBuffer[i]);
-		audio->audioMutexLock.unlock();
-		audio->modified = true;
+		audio->audioBuffer.write(audio->pSampleBuffer, audio->settings.sampleSize);
 
 		++numUpdates;
 		std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
@@ -256,7 +240,11 @@ AudioSampler& AudioSampler::operator=(AudioSampler&& other) noexcept {
 
 bool AudioSampler::running() const { return audioSamplerImpl->running; }
 
-bool AudioSampler::modified() const { return audioSamplerImpl->modified; }
+bool AudioSampler::modified() const { return audioSamplerImpl->modified(); }
+
+bool AudioSampler::waitForData(std::chrono::milliseconds timeout) {
+	return audioSamplerImpl->waitForData(timeout);
+}
 
 int AudioSampler::ups() const { return audioSamplerImpl->ups; }
 
@@ -4,9 +4,6 @@
 
 #include "../../smoothing/textureBlur.glsl"
 
-layout(constant_id = 2) const int width  = 1;
-layout(constant_id = 3) const int height = 1;
-
 layout(constant_id = 11) const float amplitude = 1.f;
 
 layout(constant_id = 12) const float saturation = 20.f;
@@ -1,8 +1,13 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
-layout(constant_id = 2) const int width  = 1;
-layout(constant_id = 3) const int height = 1;
+layout(set = 0, binding = 0) uniform data {
+	float lVolume;
+	float rVolume;
+	uint time;
+	uint width;
+	uint height;
+};
 
 layout(set = 0, binding = 3) uniform sampler2D backgroundImage;
 
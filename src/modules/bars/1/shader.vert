@@ -1,8 +1,13 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
+#extension GL_GOOGLE_include_directive : enable
 
-layout(constant_id = 2) const int width            = 1;
-layout(constant_id = 3) const int height           = 1;
+layout(constant_id = 0) const int audioSize        = 1;
+layout(constant_id = 1) const float smoothingLevel = 0.f;
+
+layout(constant_id = 11) const int barWidth = 4;
+layout(constant_id = 12) const int barGap = 2;
+layout(constant_id = 13) const float amplitude = 2.f;
 
 layout(constant_id = 18) const float limit = 1;
 
@@ -15,29 +20,79 @@ layout(constant_id = 21) const float rotation = 0;
 layout(constant_id = 22) const float xOffset = 0;
 layout(constant_id = 23) const float yOffset = 0.5;
 
-vec2 positions[6] = vec2[](
-	vec2(-1.0f, -1.0f), // top left
-	vec2( 1.0f, -1.0f),  // top right
-	vec2(-1.0f,  1.0f),  // bottom left
+// the size is read from here so that resizing the window does not rebuild the pipeline
+layout(set = 0, binding = 0) uniform data {
+	float lVolume;
+	float rVolume;
+	uint time;
+	uint width;
+	uint height;
+};
+
+layout(set = 0, binding = 1) uniform samplerBuffer lBuffer;
+layout(set = 0, binding = 2) uniform samplerBuffer rBuffer;
+
+// corners of a bar, from its left to its right edge and from its foot to its top
+vec2 corners[6] = vec2[](
+	vec2(0.0f, 1.0f), // top left
+	vec2(1.0f, 1.0f), // top right
+	vec2(0.0f, 0.0f), // bottom left
 
-	vec2( 1.0f,  1.0f),   // bottom right
-	vec2(-1.0f,  1.0f),  // bottom left
-	vec2( 1.0f, -1.0f)   // top right
+	vec2(1.0f, 0.0f), // bottom right
+	vec2(0.0f, 0.0f), // bottom left
+	vec2(1.0f, 1.0f)  // top right
 );
 
 layout(location = 0) out vec2 position;
 
 layout(location = 1) out vec2 screenDimensions;
 
-void main() {
-	mat2 transform = mat2(cos(rotation), sin(rotation), -sin(rotation), cos(rotation))
-	               * mat2(boxWidth, 0, 0, limit*boxHeight);
+#include "../../smoothing/smoothing.glsl"
 
+// every instance draws one bar, the bars repeat every barWidth + barGap pixels from the center
+// of the box and the instances past its right edge collapse to nothing
+void main() {
 	vec2 boxSize = vec2(boxWidth, boxHeight);
 	vec2 rotationXY = vec2(cos(rotation), sin(rotation));
 	vec2 screen = vec2(width, height);
-
-	gl_Position = vec4(transform*positions[gl_VertexIndex] + vec2(xOffset, yOffset) + (1-limit)*rotationXY.yx*vec2(boxHeight, boxHeight), 0.0, 1.0);
-	position = 0.5*vec2(dot(screen, rotationXY), -limit)*boxSize*(vec2(0, -1)+positions[gl_VertexIndex]);
 	screenDimensions = vec2(dot(screen, rotationXY), dot(screen, rotationXY.yx))*boxSize;
+
+	float totalBarSize = barWidth + barGap;
+	float halfWidth = 0.5*abs(screenDimensions.x);
+	float bar = floor(-halfWidth/totalBarSize) + gl_InstanceIndex;
+	float barCenter = bar*totalBarSize + 0.5f;
+
+	float left = max(bar*totalBarSize + 0.5*barGap, -halfWidth);
+	float right = max(min((bar + 1)*totalBarSize - 0.5*barGap, halfWidth), left);
+
+	const float mixThreshold = 0.03;
+
+	float texCoord = 2.0*barCenter/screenDimensions.x;
+	float v;
+
+	if (abs(texCoord) < mixThreshold)
+		v = mix(
+				kernelSmoothTexture(lBuffer, smoothingLevel, texCoord),
+				kernelSmoothTexture(rBuffer, smoothingLevel, texCoord),
+				0.5*(texCoord+mixThreshold)/mixThreshold
+			);
+	else if (bar < 0.0)
+		v = kernelSmoothTexture(lBuffer, smoothingLevel, texCoord);
+	else
+		v = kernelSmoothTexture(rBuffer, smoothingLevel, texCoord);
+
+	// fraction of the box the bar fills
+	float boxTop = limit*boxHeight;
+	float top = boxTop > 0.0 ? clamp(amplitude*v/boxTop, 0.0, 1.0) : 0.0;
+
+	vec2 corner = corners[gl_VertexIndex];
+	position = vec2(mix(left, right, corner.x), corner.y*top*boxTop);
+
+	// the position of the corner in the box of the full screen quad the bars used to be drawn on
+	vec2 quad = vec2(2.0*position.x/screenDimensions.x, 1.0 - 2.0*corner.y*top);
+
+	mat2 transform = mat2(cos(rotation), sin(rotation), -sin(rotation), cos(rotation))
+	               * mat2(boxWidth, 0, 0, limit*boxHeight);
+
+	gl_Position = vec4(transform*quad + vec2(xOffset, yOffset) + (1-limit)*rotationXY.yx*vec2(boxHeight, boxHeight), 0.0, 1.0);
 }
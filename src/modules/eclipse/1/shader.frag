@@ -1,9 +1,6 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
-layout(constant_id = 2) const int width            = 1;
-layout(constant_id = 3) const int height           = 1;
-
 layout(constant_id = 18) const int enableBackground = 1;
 
 layout(constant_id = 19) const float red1 = 0;
@@ -17,6 +14,14 @@ layout(constant_id = 24) const float blue2 = 0;
 vec3 color1 = vec3(red1, green1, blue1);
 vec3 color2 = vec3(red2, green2, blue2);
 
+layout(set = 0, binding = 0) uniform data {
+	float lVolume;
+	float rVolume;
+	uint time;
+	uint width;
+	uint height;
+};
+
 layout(location = 0) out vec4 outColor;
 
 void main() {
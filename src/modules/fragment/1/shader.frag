@@ -2,9 +2,6 @@
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_GOOGLE_include_directive : enable
 
-layout(constant_id = 2) const int width            = 1;
-layout(constant_id = 3) const int height           = 1;
-
 layout(constant_id = 13) const float red = 0;
 layout(constant_id = 14) const float green = 0;
 layout(constant_id = 15) const float blue = 0;
@@ -19,6 +16,14 @@ layout(constant_id = 20) const float brightness = 1;
 
 vec3 lightColor = vec3(lightRed, lightGreen, lightBlue);
 
+layout(set = 0, binding = 0) uniform data {
+	float lVolume;
+	float rVolume;
+	uint time;
+	uint width;
+	uint height;
+};
+
 layout(location = 0) out vec4 outColor;
 
 void main() {
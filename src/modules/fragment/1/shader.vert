@@ -2,8 +2,6 @@
 #extension GL_ARB_separate_shader_objects : enable
 
 layout(constant_id = 1) const float smoothingLevel = 0.f;
-layout(constant_id = 2) const int width            = 1;
-layout(constant_id = 3) const int height           = 1;
 layout(constant_id = 4) const int vertexCount      = 1;
 
 layout(constant_id = 11) const float radius = 0.3;
@@ -13,6 +11,8 @@ layout(set = 0, binding = 0) uniform data {
 	float lVolume;
 	float rVolume;
 	uint time;
+	uint width;
+	uint height;
 };
 
 layout(set = 0, binding = 1) uniform samplerBuffer lBuffer;
@@ -4,8 +4,6 @@
 
 layout(constant_id = 0) const int audioSize        = 1;
 layout(constant_id = 1) const float smoothingLevel = 0.0;
-layout(constant_id = 2) const int width            = 1;
-layout(constant_id = 3) const int height           = 1;
 
 layout(constant_id = 11) const int originalRadius = 128;
 layout(constant_id = 12) const float radiusSensitivity = 1.f;
@@ -15,6 +13,9 @@ layout(constant_id = 14) const float rotationFrequency = 1.f;
 layout(set = 0, binding = 0) uniform data {
 	float lVolume;
 	float rVolume;
+	uint time;
+	uint width;
+	uint height;
 };
 
 layout(set = 1, binding = 0) uniform sampler2D logo;
@@ -4,8 +4,8 @@
 
 layout(constant_id = 0) const int audioSize        = 1;
 layout(constant_id = 1) const float smoothingLevel = 0.f;
-layout(constant_id = 2) const int width            = 1;
-layout(constant_id = 3) const int height           = 1;
+// whether the spectrum images below can be sampled, they can't be filtered on every device
+layout(constant_id = 5) const int spectrumImages   = 0;
 
 layout(constant_id = 11) const float amplitude = 2.f;
 
@@ -21,10 +21,15 @@ vec3 color = vec3(red, green, blue);
 layout(set = 0, binding = 0) uniform data {
 	float lVolume;
 	float rVolume;
+	uint time;
+	uint width;
+	uint height;
 };
 
 layout(set = 0, binding = 1) uniform samplerBuffer lBuffer;
 layout(set = 0, binding = 2) uniform samplerBuffer rBuffer;
+layout(set = 0, binding = 4) uniform sampler1D lSpectrum;
+layout(set = 0, binding = 5) uniform sampler1D rSpectrum;
 
 layout(location = 0) in vec2 position;
 
@@ -33,11 +38,14 @@ layout(location = 0) out vec4 outColor;
 #include "../../smoothing/smoothing.glsl"
 
 void main() {
+	const float index = 2*abs(position.x)/width;
 	float v;
 	if (position.x < 0.0)
-		v = kernelSmoothTexture(lBuffer, smoothingLevel, -2*position.x/width);
+		v = spectrumImages == 1 ? kernelSmoothTexture(lSpectrum, smoothingLevel, index)
+		                        : kernelSmoothTexture(lBuffer, smoothingLevel, index);
 	else
-		v = kernelSmoothTexture(rBuffer, smoothingLevel, 2*position.x/width);
+		v = spectrumImages == 1 ? kernelSmoothTexture(rSpectrum, smoothingLevel, index)
+		                        : kernelSmoothTexture(rBuffer, smoothingLevel, index);
 
 	float delta = fwidth(v);
 	float alpha = 1-smoothstep(amplitude*v-bottom, amplitude*v+top, position.y);
@@ -1,9 +1,6 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
-layout(constant_id = 2) const int width            = 1;
-layout(constant_id = 3) const int height           = 1;
-
 layout(constant_id = 15) const float limit = 1;
 
 layout(constant_id = 16) const float boxWidth = 2;
@@ -25,6 +22,14 @@ vec2 positions[6] = vec2[](
 	vec2( 1.0f, -1.f)   // top right
 );
 
+layout(set = 0, binding = 0) uniform data {
+	float lVolume;
+	float rVolume;
+	uint time;
+	uint width;
+	uint height;
+};
+
 layout(location = 0) out vec2 position;
 
 void main() {
@@ -1,9 +1,6 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
-layout(constant_id = 2) const int width            = 1;
-layout(constant_id = 3) const int height           = 1;
-
 layout(constant_id = 11) const float size = 1.f;
 layout(constant_id = 12) const float cameraZ = 4.f;
 layout(constant_id = 13) const float yPos = -1.f;
@@ -58,6 +55,8 @@ layout(set = 0, binding = 0) uniform data {
 	float lVolume;
 	float rVolume;
 	uint time;
+	uint width;
+	uint height;
 };
 
 const float PI = 3.14159265359;
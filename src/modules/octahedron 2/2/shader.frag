@@ -4,8 +4,6 @@
 
 layout(constant_id = 0) const int audioSize        = 1;
 layout(constant_id = 1) const float smoothingLevel = 0.f;
-layout(constant_id = 2) const int width            = 1;
-layout(constant_id = 3) const int height           = 1;
 
 layout(constant_id = 37) const float red = 0.18039215686;
 layout(constant_id = 38) const float green = 0.20392156862;
@@ -1,9 +1,6 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
-layout(constant_id = 2) const int width            = 1;
-layout(constant_id = 3) const int height           = 1;
-
 layout(constant_id = 12) const float cameraZ = 4.f;
 layout(constant_id = 14) const float fov = 0.6; // pi/4
 
@@ -27,6 +24,14 @@ vec3 positions[] = vec3[](
 	vec3(0), vec3(0), vec3(0)
 ); // 3-1 * 2-1
 
+layout(set = 0, binding = 0) uniform data {
+	float lVolume;
+	float rVolume;
+	uint time;
+	uint width;
+	uint height;
+};
+
 layout(location = 0) out vec3 position;
 layout(location = 1) out vec3 camera;
 
@@ -4,8 +4,6 @@
 
 layout(constant_id = 0) const int audioSize        = 1;
 layout(constant_id = 1) const float smoothingLevel = 0.0;
-layout(constant_id = 2) const int width            = 1;
-layout(constant_id = 3) const int height           = 1;
 
 layout(constant_id = 11) const int ringCount        = 10;
 layout(constant_id = 12) const float ringWidth      = 20;
@@ -32,6 +30,8 @@ layout(set = 0, binding = 0) uniform data {
 	float lVolume;
 	float rVolume;
 	uint time;
+	uint width;
+	uint height;
 };
 
 layout(set = 0, binding = 1) uniform samplerBuffer lBuffer;
@@ -90,9 +90,9 @@ void main() {
 
 	float dx = mod(distance, totalRingWidth)-0.5*totalRingWidth; // distance from the center of the ring
 	if (abs(dTheta) < PI/2) {
-		float width = ringWidth*(1-(dTheta+PI/2)/PI);
+		float arcWidth = ringWidth*(1-(dTheta+PI/2)/PI);
 		float delta = fwidth(abs(dx));
-		float alpha = 1-smoothstep(width/2-delta, width/2+delta, abs(dx));
+		float alpha = 1-smoothstep(arcWidth/2-delta, arcWidth/2+delta, abs(dx));
 		outColor = vec4(color, (1-(dTheta+PI/2)/PI)*alpha);
 		return;
 	}
@@ -44,3 +44,62 @@ float mcatSmoothTexture(in samplerBuffer s, in float smoothingAmount, in float i
 
 	return val;
 }
+
+// Modules with `spectrum = image` in their config also get the spectra as 1D images at bindings
+// 4 and 5 of set 0, which the sampler mirrors and filters linearly in hardware:
+//
+// layout(set = 0, binding = 4) uniform sampler1D lSpectrum;
+// layout(set = 0, binding = 5) uniform sampler1D rSpectrum;
+//
+// Specialization constant 5 is 1 when they can be sampled, otherwise the device can't filter them
+// and the module has to read the texel buffers, as mist does.
+//
+// index is in the same units as for the texel buffers, between texels it is interpolated
+float spectrumTexture(in sampler1D s, in float index) {
+	return texture(s, index + 0.5f/textureSize(s, 0)).r;
+}
+
+// with linear filtering one fetch between two texels returns their weighted sum, halving the
+// fetches of the kernel
+float kernelSmoothTexture(in sampler1D s, in float stdDeviation, in float index) {
+	if (stdDeviation == 0.f)
+		return spectrumTexture(s, index);
+
+	const float coef = 0.5f/(stdDeviation*stdDeviation);
+	const float stepSize = 1.f/textureSize(s, 0);
+	const float radius = 3*stdDeviation;
+
+	float val = spectrumTexture(s, index);
+	for (float i = stepSize; i < radius; i += 2*stepSize) {
+		const float j = i + stepSize;
+		const float iWeight = exp(-coef*i*i);
+		const float jWeight = j < radius ? exp(-coef*j*j) : 0.f;
+		const float weight = iWeight + jWeight;
+		const float offset = (i*iWeight + j*jWeight)/weight;
+		val += weight*(spectrumTexture(s, index+offset)+spectrumTexture(s, index-offset));
+	}
+
+	return stepSize*val / (stdDeviation*sqrt(2*3.14159265359));
+}
+
+float mcatSmoothTexture(in sampler1D s, in float smoothingAmount, in float index) {
+	if (smoothingAmount == 0.f)
+		return spectrumTexture(s, index);
+
+	float val = spectrumTexture(s, index);
+
+	int size = textureSize(s, 0);
+
+	const float smoothingFactor = 1.f+1.f/smoothingAmount;
+	const float radius = log(30.f)/(log(smoothingFactor)*size);
+	const float stepSize = 1.f/size;
+	// skip i = 0
+	for (float i = stepSize; i < radius; i += stepSize) {
+		float coeff = pow(smoothingFactor, -size*i);
+		val = max(spectrumTexture(s, index+i) * coeff, val);
+		val = max(spectrumTexture(s, index-i) * coeff, val);
+	}
+	val *= 0.3;
+
+	return val;
+}
@@ -0,0 +1,16 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Draws a module rendered at a reduced resolution over the whole window
+
+layout(constant_id = 2) const int width  = 1;
+layout(constant_id = 3) const int height = 1;
+
+layout(set = 0, binding = 0) uniform sampler2D moduleImage;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+	// the sampler filters linearly, so this is a bilinear upscale
+	outColor = texture(moduleImage, gl_FragCoord.xy/vec2(width, height));
+}
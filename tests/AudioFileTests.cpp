@@ -0,0 +1,93 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "AudioFile.hpp"
+
+namespace {
+	void writeU16(std::ofstream& file, uint16_t value) {
+		file.put(value & 0xFF).put(value >> 8);
+	}
+
+	void writeU32(std::ofstream& file, uint32_t value) {
+		writeU16(file, value & 0xFFFF);
+		writeU16(file, value >> 16);
+	}
+
+	std::filesystem::path writeWav(const std::vector<int16_t>& samples, uint16_t channels,
+	                               uint32_t sampleRate) {
+		const auto path = std::filesystem::temp_directory_path() / "vkavAudioFileTest.wav";
+		std::ofstream file(path, std::ios::binary);
+
+		const uint32_t dataSize = samples.size() * sizeof(int16_t);
+		file << "RIFF";
+		writeU32(file, 4 + 8 + 16 + 8 + 8 + dataSize);
+		file << "WAVE";
+		// unknown chunks are skipped
+		file << "LIST";
+		writeU32(file, 0);
+		file << "fmt ";
+		writeU32(file, 16);
+		writeU16(file, 1);
+		writeU16(file, channels);
+		writeU32(file, sampleRate);
+		writeU32(file, sampleRate * channels * sizeof(int16_t));
+		writeU16(file, channels * sizeof(int16_t));
+		writeU16(file, 16);
+		file << "data";
+		writeU32(file, dataSize);
+		for (auto sample : samples) writeU16(file, static_cast<uint16_t>(sample));
+
+		return path;
+	}
+}  // namespace
+
+TEST(testAudioFile, read) {
+	const auto path = writeWav({0, 16384, -32768, 32767}, 2, 8000);
+	AudioFile file(path);
+	std::filesystem::remove(path);
+
+	EXPECT_EQ(file.channels(), 2);
+	EXPECT_EQ(file.sampleRate(), 8000);
+	ASSERT_EQ(file.length(), 2);
+	EXPECT_FLOAT_EQ(file.samples()[0], 0.f);
+	EXPECT_FLOAT_EQ(file.samples()[1], 0.5f);
+	EXPECT_FLOAT_EQ(file.samples()[2], -1.f);
+	EXPECT_NEAR(file.samples()[3], 1.f, 1e-4f);
+}
+
+TEST(testAudioFile, convert) {
+	const auto path = writeWav({0, 8192, 16384, 24576, 0, 8192, 16384, 24576}, 1, 8000);
+	AudioFile file(path);
+	std::filesystem::remove(path);
+
+	// mono is copied to both channels
+	const auto stereo = file.convert(8000, 2);
+	ASSERT_EQ(stereo.size(), 16);
+	EXPECT_FLOAT_EQ(stereo[2], 0.25f);
+	EXPECT_FLOAT_EQ(stereo[3], 0.25f);
+
+	// downsampling averages the samples that are combined
+	const auto downsampled = file.convert(4000, 1);
+	ASSERT_EQ(downsampled.size(), 4);
+	EXPECT_FLOAT_EQ(downsampled[0], 0.125f);
+	EXPECT_FLOAT_EQ(downsampled[1], 0.625f);
+
+	// upsampling interpolates between samples
+	const auto upsampled = file.convert(16000, 1);
+	ASSERT_EQ(upsampled.size(), 16);
+	EXPECT_FLOAT_EQ(upsampled[1], 0.125f);
+	EXPECT_FLOAT_EQ(upsampled[2], 0.25f);
+}
+
+TEST(testAudioFile, invalid) {
+	const auto path = std::filesystem::temp_directory_path() / "vkavAudioFileTest.wav";
+	std::ofstream(path) << "not a wav file";
+	EXPECT_THROW(AudioFile{path}, std::runtime_error);
+	std::filesystem::remove(path);
+
+	EXPECT_THROW(AudioFile{path}, std::runtime_error);
+}
@@ -63,6 +63,15 @@ TEST(testCalculate, constants) {
 	EXPECT_FLOAT_EQ(calculate<float>("e^2"), std::exp(2));
 }
 
+TEST(testCalculate, variables) {
+	const std::unordered_map<std::string, float> variables = {{"width", 1920}, {"e", 2}};
+	EXPECT_FLOAT_EQ(calculate<float>("width/2 - 260", variables), 700);
+	EXPECT_FLOAT_EQ(calculate<float>("min(width, 1000)", variables), 1000);
+	EXPECT_FLOAT_EQ(calculate<float>("e^2", variables), 4);
+	EXPECT_FLOAT_EQ(calculate<float>("pi", variables), M_PI);
+	EXPECT_ANY_THROW(calculate<float>("height", variables));
+}
+
 TEST(testCalculate, whitespace) {
 	EXPECT_FLOAT_EQ(calculate<float>("   \n  pi       "), M_PI);
 	EXPECT_FLOAT_EQ(calculate<float>("	 cos(        	0.0    )\n  "), 1);
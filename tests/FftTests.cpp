@@ -0,0 +1,119 @@
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "FftPlan.hpp"
+
+namespace {
+	std::vector<std::complex<float>> signal(size_t size) {
+		std::vector<std::complex<float>> data(size);
+		for (size_t i = 0; i < size; ++i)
+			data[i] = {std::sin(0.37f * i) + 0.25f * std::cos(3.1f * i), std::cos(1.3f * i)};
+		return data;
+	}
+
+	std::vector<std::complex<double>> dft(const std::vector<std::complex<float>>& data) {
+		const size_t size = data.size();
+		std::vector<std::complex<double>> out(size);
+		for (size_t k = 0; k < size; ++k)
+			for (size_t n = 0; n < size; ++n)
+				out[k] += std::complex<double>(data[n]) *
+				          std::polar(1.0, -2.0 * M_PI * static_cast<double>(k * n % size) / size);
+		return out;
+	}
+}  // namespace
+
+TEST(testFft, twiddles) {
+	FftPlan plan(1024);
+	ASSERT_EQ(plan.size(), 1024);
+	for (size_t k = 0; k < 512; ++k) {
+		EXPECT_NEAR(plan.twiddle(k).real(), std::cos(-2.0 * M_PI * k / 1024), 1e-7);
+		EXPECT_NEAR(plan.twiddle(k).imag(), std::sin(-2.0 * M_PI * k / 1024), 1e-7);
+	}
+}
+
+TEST(testFft, matchesDft) {
+	for (size_t size = 2; size <= 2048; size <<= 1) {
+		FftPlan plan(size);
+		auto data = signal(size);
+		auto expected = dft(data);
+		plan.fft(data.data(), size);
+		for (size_t k = 0; k < size; ++k) {
+			EXPECT_NEAR(data[k].real(), expected[k].real(), 1e-3 * std::sqrt(size)) << size;
+			EXPECT_NEAR(data[k].imag(), expected[k].imag(), 1e-3 * std::sqrt(size)) << size;
+		}
+	}
+}
+
+TEST(testFft, smallerSizes) {
+	FftPlan plan(4096);
+	for (size_t size = 1; size <= 4096; size <<= 1) {
+		auto data = signal(size);
+		auto expected = data;
+		FftPlan(size).fft(expected.data(), size);
+		plan.fft(data.data(), size);
+		for (size_t k = 0; k < size; ++k) {
+			EXPECT_FLOAT_EQ(data[k].real(), expected[k].real());
+			EXPECT_FLOAT_EQ(data[k].imag(), expected[k].imag());
+		}
+	}
+}
+
+TEST(testFft, inverse) {
+	FftPlan plan(8192);
+	auto data = signal(8192);
+	auto original = data;
+	plan.fft(data.data(), data.size());
+	plan.ifft(data.data(), data.size());
+	for (size_t i = 0; i < data.size(); ++i) {
+		EXPECT_NEAR(data[i].real(), original[i].real(), 1e-4);
+		EXPECT_NEAR(data[i].imag(), original[i].imag(), 1e-4);
+	}
+}
+
+TEST(testFft, window) {
+	FftPlan plan(1024);
+	auto data = signal(1024);
+	auto window = signal(1024);
+	auto expected = data;
+	for (size_t i = 0; i < expected.size(); ++i)
+		expected[i] = {data[i].real() * window[i].real(), data[i].imag() * window[i].imag()};
+
+	plan.fft(expected.data(), expected.size());
+	plan.fft(data.data(), data.size(), window.data());
+	for (size_t k = 0; k < data.size(); ++k) {
+		EXPECT_FLOAT_EQ(data[k].real(), expected[k].real());
+		EXPECT_FLOAT_EQ(data[k].imag(), expected[k].imag());
+	}
+}
+
+TEST(testFft, instructionSets) {
+	for (auto isa : {FftPlan::Isa::sse2, FftPlan::Isa::avx2, FftPlan::Isa::avx512,
+	                 FftPlan::Isa::neon}) {
+		if (!FftPlan::supported(isa)) {
+			EXPECT_ANY_THROW(FftPlan(16, isa));
+			continue;
+		}
+
+		FftPlan plan(4096, isa);
+		FftPlan scalar(4096, FftPlan::Isa::scalar);
+		ASSERT_EQ(plan.isa(), isa);
+		for (size_t size = 1; size <= 4096; size <<= 1) {
+			auto data = signal(size);
+			auto expected = data;
+			scalar.fft(expected.data(), size);
+			plan.fft(data.data(), size);
+			for (size_t k = 0; k < size; ++k) {
+				EXPECT_NEAR(data[k].real(), expected[k].real(), 1e-5 * size) << FftPlan::name(isa);
+				EXPECT_NEAR(data[k].imag(), expected[k].imag(), 1e-5 * size) << FftPlan::name(isa);
+			}
+		}
+	}
+}
+
+TEST(testFft, invalidSize) {
+	EXPECT_ANY_THROW(FftPlan(0));
+	EXPECT_ANY_THROW(FftPlan(1000));
+}
@@ -0,0 +1,46 @@
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "FrameWriter.hpp"
+
+TEST(testFrameWriter, y4m) {
+	const auto path = std::filesystem::temp_directory_path() / "vkavFrameWriterTest.y4m";
+
+	// a white and a black pixel, then a red and a blue one
+	const unsigned char frames[2][8] = {{255, 255, 255, 255, 0, 0, 0, 255},
+	                                    {255, 0, 0, 255, 0, 0, 255, 0}};
+	{
+		FrameWriter writer(path, 2, 1, 30);
+		writer.write(frames[0]);
+		writer.write(frames[1]);
+		writer.close();
+	}
+
+	std::ifstream file(path, std::ios::binary);
+	const std::string output((std::istreambuf_iterator<char>(file)),
+	                         std::istreambuf_iterator<char>());
+	file.close();
+	std::filesystem::remove(path);
+
+	const std::string header = "YUV4MPEG2 W2 H1 F30:1 Ip A1:1 C444\n";
+	ASSERT_EQ(output.size(), header.size() + 2 * (6 + 6));
+	EXPECT_EQ(output.substr(0, header.size()), header);
+
+	// planes are written one after another, Y then Cb then Cr
+	const std::string first = output.substr(header.size(), 12);
+	EXPECT_EQ(first.substr(0, 6), "FRAME\n");
+	EXPECT_EQ(static_cast<unsigned char>(first[6]), 235);
+	EXPECT_EQ(static_cast<unsigned char>(first[7]), 16);
+	EXPECT_EQ(static_cast<unsigned char>(first[8]), 128);
+	EXPECT_EQ(static_cast<unsigned char>(first[11]), 128);
+
+	const std::string second = output.substr(header.size() + 12, 12);
+	EXPECT_EQ(second.substr(0, 6), "FRAME\n");
+	// red has the highest Cr and blue the highest Cb
+	EXPECT_EQ(static_cast<unsigned char>(second[10]), 240);
+	EXPECT_EQ(static_cast<unsigned char>(second[9]), 240);
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include "Governor.hpp"
+
+namespace {
+	// feeds a whole window of frames taking time, returns whether the level changed
+	bool window(Governor& governor, float time) {
+		bool changed = false;
+		for (size_t i = 0; i < 10; ++i) changed = governor.update(time) || changed;
+		return changed;
+	}
+}  // namespace
+
+TEST(testGovernor, stepsDown) {
+	Governor::Settings settings;
+	settings.budget = 10.f;
+	settings.maxLevel = 2;
+	settings.window = 10;
+	Governor governor(settings);
+
+	EXPECT_FALSE(window(governor, 9.f));
+	EXPECT_EQ(governor.level(), 0);
+
+	EXPECT_TRUE(window(governor, 15.f));
+	EXPECT_EQ(governor.level(), 1);
+
+	// the window after a change is ignored
+	EXPECT_FALSE(window(governor, 15.f));
+	EXPECT_TRUE(window(governor, 15.f));
+	EXPECT_EQ(governor.level(), 2);
+
+	// there is no level below the cheapest
+	window(governor, 15.f);
+	EXPECT_FALSE(window(governor, 15.f));
+	EXPECT_EQ(governor.level(), 2);
+}
+
+TEST(testGovernor, hysteresis) {
+	Governor::Settings settings;
+	settings.budget = 10.f;
+	settings.maxLevel = 1;
+	settings.window = 10;
+	settings.headroom = 0.5f;
+	settings.upWindows = 3;
+	Governor governor(settings);
+
+	window(governor, 15.f);
+	window(governor, 15.f);
+	ASSERT_EQ(governor.level(), 1);
+
+	// under the budget but without enough headroom the level is kept
+	for (int i = 0; i < 5; ++i) EXPECT_FALSE(window(governor, 8.f));
+
+	// a window without headroom restarts the count
+	EXPECT_FALSE(window(governor, 4.f));
+	EXPECT_FALSE(window(governor, 4.f));
+	EXPECT_FALSE(window(governor, 8.f));
+	EXPECT_FALSE(window(governor, 4.f));
+	EXPECT_FALSE(window(governor, 4.f));
+	EXPECT_TRUE(window(governor, 4.f));
+	EXPECT_EQ(governor.level(), 0);
+}
+
+TEST(testGovernor, outliers) {
+	Governor::Settings settings;
+	settings.budget = 10.f;
+	settings.maxLevel = 1;
+	settings.window = 10;
+	Governor governor(settings);
+
+	// a single slow frame in a window is tolerated
+	governor.update(50.f);
+	for (int i = 0; i < 9; ++i) EXPECT_FALSE(governor.update(5.f));
+	EXPECT_EQ(governor.level(), 0);
+}
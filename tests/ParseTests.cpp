@@ -25,6 +25,8 @@ TEST(testParse, basic) {
 	ASSERT_TRUE(config.vertexCount);
 	EXPECT_EQ(config.vertexCount.value(), 24);
 
+	ASSERT_TRUE(!config.bands);
+
 	// Resources
 	ASSERT_EQ(config.images.size(), 1);
 
@@ -35,10 +37,124 @@ TEST(testParse, basic) {
 	ASSERT_EQ(config.params.size(), 2);
 
 	EXPECT_EQ(config.params[0].id, 11);
+	EXPECT_EQ(config.params[0].name, "size");
 	ASSERT_EQ(config.params[0].value.index(), 1);
 	EXPECT_EQ(std::get<1>(config.params[0].value), 1);
 
 	EXPECT_EQ(config.params[1].id, 12);
+	EXPECT_EQ(config.params[1].name, "xPos");
 	ASSERT_EQ(config.params[1].value.index(), 2);
 	EXPECT_EQ(std::get<2>(config.params[1].value), 3.f);
 }
+
+TEST(testParse, bands) {
+	std::stringstream stream{
+		"[global]\n"
+		"bands = 16*4 # log spaced\n"
+	};
+
+	auto config = parseConfig(stream);
+
+	ASSERT_TRUE(config.bands);
+	EXPECT_EQ(config.bands.value(), 64);
+}
+
+TEST(testParse, instanceSize) {
+	std::stringstream stream{
+		"[global]\n"
+		"vertexCount = 6\n"
+		"instanceSize = 4 + 2\n"
+	};
+
+	auto config = parseConfig(stream);
+
+	ASSERT_TRUE(config.vertexCount);
+	EXPECT_EQ(config.vertexCount.value(), 6u);
+	ASSERT_TRUE(config.instanceSize);
+	EXPECT_FLOAT_EQ(config.instanceSize.value(), 6.f);
+
+	std::stringstream parameters{
+		"instanceSize = barWidth + barGap\n"
+		"[parameters]\n"
+		"(id=11) int barWidth = 3\n"
+		"(id=12) float barGap = 1.5\n"
+	};
+	auto parameterConfig = parseConfig(parameters);
+	ASSERT_TRUE(parameterConfig.instanceSize);
+	EXPECT_FLOAT_EQ(parameterConfig.instanceSize.value(), 4.5f);
+
+	std::stringstream unknown{"instanceSize = barWidth\n"};
+	EXPECT_THROW(parseConfig(unknown), ParseException);
+}
+
+TEST(testParse, renderScale) {
+	std::stringstream stream{
+		"[global]\n"
+		"renderScale = 1/2\n"
+	};
+
+	auto config = parseConfig(stream);
+
+	ASSERT_TRUE(config.renderScale);
+	EXPECT_FLOAT_EQ(config.renderScale.value(), 0.5f);
+}
+
+TEST(testParse, smoothing) {
+	std::stringstream stream{
+		"[global]\n"
+		"smoothing = mcat # comment\n"
+		"smoothingLevel = 0.02\n"
+	};
+
+	auto config = parseConfig(stream);
+
+	ASSERT_TRUE(config.smoothing);
+	EXPECT_EQ(config.smoothing.value(), "mcat");
+	ASSERT_TRUE(config.smoothingLevel);
+	EXPECT_FLOAT_EQ(config.smoothingLevel.value(), 0.02f);
+}
+
+TEST(testParse, bounds) {
+	std::stringstream stream{
+		"[global]\n"
+		"bounds = width/2 - max(100, 50), 0, 200, height # comment\n"
+	};
+
+	auto config = parseConfig(stream);
+
+	ASSERT_TRUE(config.bounds);
+	EXPECT_EQ(config.bounds.value()[0], "width/2 - max(100, 50)");
+	EXPECT_EQ(config.bounds.value()[1], "0");
+	EXPECT_EQ(config.bounds.value()[3], "height");
+
+	std::stringstream parameters{
+		"bounds = width/2 - radius, height/2 - radius, 2*radius, 2*(radius + width)\n"
+		"[parameters]\n"
+		"(id=11) int radius = 64\n"
+		"(id=12) float width = 0.5\n"
+	};
+	auto parameterConfig = parseConfig(parameters);
+	ASSERT_TRUE(parameterConfig.bounds);
+	EXPECT_EQ(parameterConfig.bounds.value()[2], "2*radius");
+
+	std::stringstream unknown{"bounds = 0, 0, radius, 100\n"};
+	EXPECT_THROW(parseConfig(unknown), ParseException);
+
+	std::stringstream missing{"bounds = 0, 0, 100\n"};
+	EXPECT_THROW(parseConfig(missing), ParseException);
+
+	std::stringstream extra{"bounds = 0, 0, 100, 100, 100\n"};
+	EXPECT_THROW(parseConfig(extra), ParseException);
+}
+
+TEST(testParse, spectrum) {
+	std::stringstream stream{
+		"[global]\n"
+		"spectrum = image\n"
+	};
+
+	auto config = parseConfig(stream);
+
+	ASSERT_TRUE(config.spectrum);
+	EXPECT_EQ(config.spectrum.value(), "image");
+}
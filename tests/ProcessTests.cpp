@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Data.hpp"
+#include "Process.hpp"
+
+namespace {
+	float sample(size_t n, unsigned char channel) {
+		return std::sin(0.21f * n + channel) + 0.5f * std::sin(1.7f * n) +
+		       0.25f * std::cos(0.013f * n * n / (channel + 1));
+	}
+
+	// fills buffer with the window of the signal ending at sample end
+	void fillWindow(AudioData& audioData, size_t size, unsigned char channels, size_t end) {
+		for (size_t n = 0; n < size; ++n)
+			for (unsigned char c = 0; c < channels; ++c)
+				audioData.buffer[channels * n + c] = sample(end - size + n, c);
+	}
+
+	void compareAnalysis(unsigned char channels, size_t bins = 900, float smoothingLevel = 0.f) {
+		const size_t size = 2048;
+		const size_t chunk = 64;
+
+		Process::Settings settings = {};
+		settings.size = size;
+		settings.bins = bins;
+		settings.amplitude = 1.f;
+		settings.channels = channels;
+		settings.smoothingLevel = smoothingLevel;
+
+		settings.analysis = Process::Analysis::full;
+		Process full(settings);
+		settings.analysis = Process::Analysis::sliding;
+		Process sliding(settings);
+
+		AudioData expected, actual;
+		expected.allocate(channels, size);
+		actual.allocate(channels, size);
+
+		actual.newSamples = size;
+		for (size_t end = size; end < 4 * size; end += chunk) {
+			fillWindow(expected, size, channels, end);
+			fillWindow(actual, size, channels, end);
+			full.processSignal(expected);
+			sliding.processSignal(actual);
+			actual.newSamples = chunk;
+
+			float peak = *std::max_element(expected.lBuffer, expected.lBuffer + bins);
+			for (size_t k = 0; k < bins; ++k) {
+				ASSERT_NEAR(actual.lBuffer[k], expected.lBuffer[k], 2e-3f * peak) << end;
+				ASSERT_NEAR(actual.rBuffer[k], expected.rBuffer[k], 2e-3f * peak) << end;
+			}
+			for (size_t k = bins; k < size / 2; ++k) {
+				ASSERT_EQ(actual.lBuffer[k], 0.f);
+				ASSERT_EQ(actual.rBuffer[k], 0.f);
+			}
+		}
+	}
+}  // namespace
+
+TEST(testProcess, slidingMono) { compareAnalysis(1); }
+
+TEST(testProcess, slidingStereo) { compareAnalysis(2); }
+
+// the smoothing mixes in the bins above the displayed ones, so all of them are compared
+TEST(testProcess, slidingSmoothed) {
+	compareAnalysis(2, 1024, 0.01f);
+	compareAnalysis(2, 1024, 0.4f);
+}
+
+TEST(testProcess, bands) {
+	const size_t size = 2048;
+	const size_t bins = 900;
+	const size_t bands = 32;
+
+	Process::Settings settings = {};
+	settings.size = size;
+	settings.bins = bins;
+	settings.amplitude = 1.f;
+	settings.channels = 2;
+	settings.bands = bands;
+	Process process(settings);
+
+	AudioData audioData;
+	audioData.allocate(2, size);
+
+	for (size_t bin : {3, 40, 500}) {
+		for (size_t n = 0; n < size; ++n) {
+			audioData.buffer[2 * n] = std::sin(2 * M_PI * bin * n / size);
+			audioData.buffer[2 * n + 1] = 0.f;
+		}
+		process.processSignal(audioData);
+
+		// the loudest band is the one whose centre is closest to the frequency on a log scale
+		const double expected = std::round((bands + 1) * std::log(bin) / std::log(bins - 1)) - 1;
+		const double loudest =
+		    std::max_element(audioData.lBuffer, audioData.lBuffer + bands) - audioData.lBuffer;
+		EXPECT_NEAR(loudest, expected, 1) << bin;
+		for (size_t b = 0; b < bands; ++b) EXPECT_NEAR(audioData.rBuffer[b], 0.f, 1e-5f);
+	}
+}
+
+TEST(testProcess, reducedFftSize) {
+	const size_t size = 2048;
+
+	for (unsigned char channels : {1, 2}) {
+		Process::Settings settings = {};
+		settings.size = size;
+		settings.amplitude = 1.f;
+		settings.channels = channels;
+		Process process(settings);
+
+		AudioData audioData;
+		audioData.allocate(channels, size);
+
+		for (size_t reduced : {size / 2, size / 4}) {
+			process.setFftSize(reduced);
+			for (size_t bin : {40, 400}) {
+				for (size_t n = 0; n < channels * size; ++n)
+					audioData.buffer[n] = std::sin(2 * M_PI * bin * (n / channels) / size);
+				process.processSignal(audioData);
+
+				// the peak stays at the bin of the full size
+				const size_t loudest =
+				    std::max_element(audioData.lBuffer, audioData.lBuffer + size / 2) -
+				    audioData.lBuffer;
+				EXPECT_EQ(loudest, bin) << reduced;
+				EXPECT_GT(audioData.lVolume, 0.f);
+				EXPECT_FLOAT_EQ(audioData.lBuffer[bin], audioData.rBuffer[bin]);
+			}
+		}
+	}
+}
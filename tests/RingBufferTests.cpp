@@ -0,0 +1,61 @@
+#include <cstdint>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "RingBuffer.hpp"
+
+TEST(testRingBuffer, wrapAround) {
+	RingBuffer<int> buffer;
+	buffer.allocate(6);
+
+	std::vector<int> chunk(5);
+	std::vector<int> latest(6);
+
+	EXPECT_FALSE(buffer.unread());
+	EXPECT_EQ(buffer.readLatest(latest.data(), latest.size()), 0);
+	EXPECT_EQ(latest, std::vector<int>(6, 0));
+
+	for (int i = 0; i < 10; ++i) {
+		std::iota(chunk.begin(), chunk.end(), 5 * i);
+		buffer.write(chunk.data(), chunk.size());
+		ASSERT_TRUE(buffer.unread());
+		if (i % 2) {
+			ASSERT_EQ(buffer.readLatest(latest.data(), latest.size()), 10);
+			for (int j = 0; j < 6; ++j) EXPECT_EQ(latest[j], 5 * i - 1 + j);
+			EXPECT_FALSE(buffer.unread());
+		}
+	}
+}
+
+TEST(testRingBuffer, threaded) {
+	constexpr size_t chunkSize = 64;
+	constexpr size_t windowSize = 2048;
+	constexpr uint32_t count = 1 << 22;
+
+	RingBuffer<uint32_t> buffer;
+	buffer.allocate(windowSize);
+
+	std::thread producer([&]() {
+		std::vector<uint32_t> chunk(chunkSize);
+		for (uint32_t i = 0; i < count; i += chunkSize) {
+			std::iota(chunk.begin(), chunk.end(), i + 1);
+			buffer.write(chunk.data(), chunk.size());
+		}
+	});
+
+	std::vector<uint32_t> window(windowSize);
+	size_t total = 0;
+	while (total < count) {
+		total += buffer.readLatest(window.data(), window.size());
+		ASSERT_EQ(window.back(), total);
+		for (size_t i = 1; i < window.size(); ++i) {
+			if (window[i - 1]) {
+				ASSERT_EQ(window[i - 1] + 1, window[i]);
+			}
+		}
+	}
+	producer.join();
+}
@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+
+#include "RollingStatistics.hpp"
+
+TEST(testRollingStatistics, summary) {
+	RollingStatistics statistics(100);
+	EXPECT_TRUE(statistics.empty());
+	EXPECT_EQ(statistics.average(), 0.f);
+
+	for (int i = 1; i <= 100; ++i) statistics.add(static_cast<float>(i));
+	EXPECT_EQ(statistics.size(), 100);
+	EXPECT_FLOAT_EQ(statistics.min(), 1.f);
+	EXPECT_FLOAT_EQ(statistics.average(), 50.5f);
+	EXPECT_FLOAT_EQ(statistics.percentile(0.99f), 99.f);
+	EXPECT_FLOAT_EQ(statistics.percentile(1.f), 100.f);
+	EXPECT_FLOAT_EQ(statistics.percentile(0.f), 1.f);
+}
+
+TEST(testRollingStatistics, rolling) {
+	RollingStatistics statistics(4);
+	for (int i = 0; i < 4; ++i) statistics.add(10.f);
+	EXPECT_FLOAT_EQ(statistics.average(), 10.f);
+
+	// the oldest samples are replaced first
+	for (int i = 0; i < 3; ++i) statistics.add(2.f);
+	EXPECT_EQ(statistics.size(), 4);
+	EXPECT_FLOAT_EQ(statistics.min(), 2.f);
+	EXPECT_FLOAT_EQ(statistics.average(), 4.f);
+	EXPECT_FLOAT_EQ(statistics.percentile(0.99f), 10.f);
+
+	statistics.add(2.f);
+	EXPECT_FLOAT_EQ(statistics.percentile(0.99f), 2.f);
+}
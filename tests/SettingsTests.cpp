@@ -1,3 +1,7 @@
+#include <cstdlib>
+#include <optional>
+#include <string>
+
 #include <gtest/gtest.h>
 
 #include "Settings.hpp"
@@ -58,3 +62,31 @@ TEST(testSettings, parseAsPair) {
 		EXPECT_EQ(pair.second, "asd");
 	}
 }
+
+#ifdef LINUX
+TEST(testSettings, cacheLocation) {
+	// the environment is shared with the other tests in this binary, so restore it afterwards
+	auto save = [](const char* name) -> std::optional<std::string> {
+		const char* value = std::getenv(name);
+		return value ? std::optional<std::string>(value) : std::nullopt;
+	};
+	auto restore = [](const char* name, const std::optional<std::string>& value) {
+		if (value)
+			setenv(name, value->c_str(), 1);
+		else
+			unsetenv(name);
+	};
+	const auto xdgCacheHome = save("XDG_CACHE_HOME");
+	const auto home = save("HOME");
+
+	setenv("XDG_CACHE_HOME", "/path/to/cache", 1);
+	EXPECT_EQ(getCacheLocation(), "/path/to/cache/vkav");
+
+	setenv("XDG_CACHE_HOME", "", 1);
+	setenv("HOME", "/home/user", 1);
+	EXPECT_EQ(getCacheLocation(), "/home/user/.cache/vkav");
+
+	restore("XDG_CACHE_HOME", xdgCacheHome);
+	restore("HOME", home);
+}
+#endif
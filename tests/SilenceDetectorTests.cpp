@@ -0,0 +1,29 @@
+#include <gtest/gtest.h>
+
+#include "SilenceDetector.hpp"
+
+TEST(testSilenceDetector, idle) {
+	const SilenceDetector::Duration chunk(0.25f);
+	SilenceDetector detector(0.1f, SilenceDetector::Duration(1.f));
+	EXPECT_FALSE(detector.idle());
+
+	for (int i = 0; i < 3; ++i) EXPECT_FALSE(detector.update(0.05f, chunk));
+	EXPECT_TRUE(detector.update(0.05f, chunk));
+	EXPECT_TRUE(detector.idle());
+	EXPECT_TRUE(detector.update(0.f, chunk));
+
+	// a single loud chunk wakes the detector and restarts the timeout
+	EXPECT_FALSE(detector.update(0.2f, chunk));
+	EXPECT_FALSE(detector.idle());
+	for (int i = 0; i < 3; ++i) EXPECT_FALSE(detector.update(0.05f, chunk));
+	EXPECT_TRUE(detector.update(0.05f, chunk));
+}
+
+TEST(testSilenceDetector, disabled) {
+	SilenceDetector detector(0.1f, SilenceDetector::Duration::zero());
+	for (int i = 0; i < 100; ++i)
+		EXPECT_FALSE(detector.update(0.f, SilenceDetector::Duration(1.f)));
+
+	SilenceDetector defaultDetector;
+	EXPECT_FALSE(defaultDetector.update(0.f, SilenceDetector::Duration(1.f)));
+}
@@ -0,0 +1,61 @@
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Spirv.hpp"
+
+namespace {
+	// the test executable may not be run from the source directory
+	std::vector<char> readFile(const char* path) {
+		std::ifstream file(path, std::ios::binary);
+		return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+	}
+}  // namespace
+
+TEST(testSpirv, uniformBlock) {
+	// lVolume, rVolume, time, width and height
+	EXPECT_EQ(uniformBlockMemberCount(readFile(MODULES_DIR "/rings/1/frag.spv"), 0, 0), 5);
+	// lVolume and rVolume
+	EXPECT_EQ(uniformBlockMemberCount(readFile(MODULES_DIR "/bars/1/frag.spv"), 0, 0), 2);
+	// unused
+	EXPECT_EQ(uniformBlockMemberCount(readFile(MODULES_DIR "/vert.spv"), 0, 0), 0);
+	// samplers are not uniform blocks
+	EXPECT_EQ(uniformBlockMemberCount(readFile(MODULES_DIR "/bars/1/frag.spv"), 0, 1), 0);
+}
+
+TEST(testSpirv, uniformBlockMember) {
+	// time
+	EXPECT_TRUE(uniformBlockMemberUsed(readFile(MODULES_DIR "/rings/1/frag.spv"), 0, 0, 2));
+	// width and height, time is only declared to reach them
+	const auto bars = readFile(MODULES_DIR "/bars/1/vert.spv");
+	EXPECT_EQ(uniformBlockMemberCount(bars, 0, 0), 5);
+	EXPECT_FALSE(uniformBlockMemberUsed(bars, 0, 0, 2));
+	EXPECT_TRUE(uniformBlockMemberUsed(bars, 0, 0, 3));
+	EXPECT_TRUE(uniformBlockMemberUsed(bars, 0, 0, 4));
+	// unused
+	EXPECT_FALSE(uniformBlockMemberUsed(readFile(MODULES_DIR "/vert.spv"), 0, 0, 0));
+}
+
+TEST(testSpirv, specializationConstant) {
+	// the modules read the window size from the uniform block
+	const auto rings = readFile(MODULES_DIR "/rings/1/frag.spv");
+	EXPECT_TRUE(hasSpecializationConstant(rings, 11));
+	EXPECT_FALSE(hasSpecializationConstant(rings, 2));
+	EXPECT_FALSE(hasSpecializationConstant(rings, 3));
+	const auto bars = readFile(MODULES_DIR "/bars/1/vert.spv");
+	EXPECT_FALSE(hasSpecializationConstant(bars, 2));
+	EXPECT_FALSE(hasSpecializationConstant(bars, 3));
+	EXPECT_TRUE(hasSpecializationConstant(bars, 18));
+	EXPECT_FALSE(hasSpecializationConstant(bars, 17));
+	// the shared vertex shader does not depend on the window size
+	EXPECT_FALSE(hasSpecializationConstant(readFile(MODULES_DIR "/vert.spv"), 2));
+}
+
+TEST(testSpirv, invalid) {
+	EXPECT_ANY_THROW(uniformBlockMemberCount({}, 0, 0));
+	EXPECT_ANY_THROW(uniformBlockMemberCount(std::vector<char>(20, 1), 0, 0));
+	EXPECT_ANY_THROW(hasSpecializationConstant({}, 0));
+	EXPECT_ANY_THROW(uniformBlockMemberUsed({}, 0, 0, 0));
+}
@@ -0,0 +1,52 @@
+#include <atomic>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "TripleBuffer.hpp"
+
+TEST(testTripleBuffer, update) {
+	TripleBuffer<int> buffer;
+	buffer.forEach([](int& val) { val = 0; });
+
+	EXPECT_FALSE(buffer.update());
+
+	buffer.back() = 1;
+	buffer.publish();
+	buffer.back() = 2;
+	buffer.publish();
+
+	// only the latest value is received
+	ASSERT_TRUE(buffer.update());
+	EXPECT_EQ(buffer.front(), 2);
+	EXPECT_FALSE(buffer.update());
+	EXPECT_EQ(buffer.front(), 2);
+}
+
+TEST(testTripleBuffer, threaded) {
+	struct Data {
+		int a;
+		int b;
+	};
+	constexpr int count = 200000;
+
+	TripleBuffer<Data> buffer;
+	buffer.forEach([](Data& val) { val = {0, 0}; });
+
+	std::thread producer([&]() {
+		for (int i = 1; i <= count; ++i) {
+			buffer.back() = {i, -i};
+			buffer.publish();
+		}
+	});
+
+	int last = 0;
+	while (last != count) {
+		if (!buffer.update()) continue;
+		const Data& data = buffer.front();
+		ASSERT_EQ(data.a, -data.b);
+		ASSERT_GT(data.a, last);
+		last = data.a;
+	}
+	producer.join();
+}